@@ -17,11 +17,26 @@
 /// worker thread for execution. The context on the main IRCd thread yields until the offload
 /// function has returned (or thrown).
 ///
+/// The engine spawns up to `thread_max` worker threads on demand, optionally pinned to the
+/// CPUs listed in `thread_affinity`. Each worker has its own fixed-size submission ring.
+/// Since submissions are only made from the main thread each ring has a single producer; it
+/// is consumed without locking by its owner and by any other worker which has run out of
+/// work and steals from it. Workers sleep when there is nothing to do anywhere.
+///
+/// A batch of functions may be submitted at once. They are distributed over the workers and
+/// may execute concurrently; the context yields until all of them have completed. If any
+/// threw, the first exception in the order of submission is rethrown to the caller.
+///
 namespace ircd::ctx::ole
 {
 	struct init;
+	using closure = std::function<void ()>;
+
+	extern conf::item<size_t> thread_max;
+	extern conf::item<std::string> thread_affinity;
 
-	void offload(const std::function<void ()> &);
+	void offload(const vector_view<const closure> &);
+	void offload(const closure &);
 }
 
 namespace ircd::ctx
@@ -22,7 +22,7 @@
 namespace ircd::db
 {
 	// Get our stats; refer to db/stats.h for ticker ID related.
-	const uint64_t &ticker(const rocksdb::Cache &, const uint32_t &ticker_id);
+	uint64_t ticker(const rocksdb::Cache &, const uint32_t &ticker_id);
 	uint64_t ticker(const rocksdb::Cache *const &, const uint32_t &ticker_id);
 
 	// Get capacity
@@ -62,7 +62,9 @@ namespace ircd::db
 	bool remove(rocksdb::Cache &, const string_view &key);
 	bool remove(rocksdb::Cache *const &, const string_view &key);
 
-	// Clear the cache (won't clear entries which are actively referenced)
+	// Clear the cache (won't clear entries which are actively referenced).
+	// Clearing a column's view of a database's shared cache clears the
+	// shared cache for all of its columns.
 	void clear(rocksdb::Cache &);
 	void clear(rocksdb::Cache *const &);
 }
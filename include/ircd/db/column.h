@@ -57,6 +57,12 @@ namespace ircd::db
 	string_view read(column &, const string_view &key, bool &found, const mutable_buffer &, const gopts & = {});
 	std::string read(column &, const string_view &key, bool &found, const gopts & = {});
 
+	// [GET] Batched point lookups conducted as one coalesced query; the keys
+	// may span columns of the same database. Values are returned in the order
+	// of the input and the found vector is resized to indicate each result.
+	std::vector<std::string> read(const vector_view<const std::pair<column *, string_view>> &, std::vector<bool> &found, const gopts & = {});
+	std::vector<std::string> read(column &, const vector_view<const string_view> &keys, std::vector<bool> &found, const gopts & = {});
+
 	// [SET] Write data to the db
 	void write(column &, const string_view &key, const const_buffer &value, const sopts & = {});
 
@@ -40,6 +40,10 @@ namespace ircd::db
 /// source record is simply forgotten without a delete record. User can set
 /// `skip_until` in the args structure to apply this non-action to a range.
 ///
+/// Note that when the database env executes background jobs on kernel threads
+/// (see ircd.db.env.pool.threads) the callback is invoked on such a thread.
+/// It must not yield, use any ircd::ctx facility, or query the database.
+///
 struct ircd::db::compactor
 {
 	struct args;
@@ -23,7 +23,7 @@ namespace ircd::db
 	const std::string &name(const database &);
 	const std::string &uuid(const database &);
 	uint64_t sequence(const database &); // Latest sequence number
-	const std::vector<std::string> &errors(const database &);
+	std::vector<std::string> errors(const database &);
 	std::vector<std::string> files(const database &, uint64_t &msz);
 	std::vector<std::string> files(const database &);
 	std::vector<std::string> wals(const database &);
@@ -110,6 +110,7 @@ struct ircd::db::database
 	std::unique_ptr<struct wal_filter> wal_filter;
 	std::shared_ptr<rocksdb::SstFileManager> ssts;
 	std::shared_ptr<rocksdb::Cache> row_cache;
+	std::shared_ptr<struct cache> block_cache; // shared by columns
 	std::vector<descriptor> descriptors;
 	std::unique_ptr<rocksdb::DBOptions> opts;
 	std::unordered_map<string_view, std::shared_ptr<column>> column_names;
@@ -119,6 +120,8 @@ struct ircd::db::database
 	std::string uuid;
 	std::unique_ptr<rocksdb::Checkpoint> checkpointer;
 	std::vector<std::string> errors;
+	mutable std::mutex errors_mutex;  // errors arrive from env threads
+	callbacks<void (const txn &), false> on_commit;  // after each txn commits
 
 	operator std::shared_ptr<database>()         { return shared_from_this();                      }
 	operator const rocksdb::DB &() const         { return *d;                                      }
@@ -18,11 +18,32 @@
 /// This is an internal wrapper over RocksDB's cache implementation. This is
 /// not the public interface to the caches intended to be used by developers
 /// of IRCd; that interface is instead found in db/cache.h.
+///
+/// An instance is either standalone, owning its own LRU, or a view into a
+/// cache shared by all columns of a database. The database constructs the
+/// shared root and each column's block cache is a view which accounts for
+/// the occupancy of that column. A view's capacity is its soft quota; the
+/// root's capacity is the sum of the quotas, so an idle column's share is
+/// available to a busy one.
+///
+/// Admission into the shared cache is frequency based (TinyLFU): lookups
+/// feed a count-min sketch and an insert is placed into the protected
+/// (high priority) pool of the LRU only if its key has been seen before;
+/// otherwise it enters the probation pool and is the first to be evicted.
+/// A one-off scan thus churns only the probation pool. A column under its
+/// hard minimum is always admitted into the protected pool, and a column
+/// over its quota never is. Lookups made by a read which does not fill the
+/// cache (i.e. get::SCAN) are not sampled; see cache::scan.
 struct ircd::db::database::cache
 final
 :std::enable_shared_from_this<ircd::db::database::cache>
 ,rocksdb::Cache
 {
+	struct quota;
+	struct entry;
+	struct sketch;
+	struct scan;
+
 	using Slice = rocksdb::Slice;
 	using Status = rocksdb::Status;
 	using deleter = void (*)(const Slice &key, void *value);
@@ -32,12 +53,23 @@ final
 	static const ssize_t DEFAULT_SHARD_BITS;
 	static const double DEFAULT_HI_PRIO;
 	static const bool DEFAULT_STRICT;
+	static conf::item<bool> shared_enable;
+	static conf::item<double> shared_hi_prio;
+	static conf::item<double> shared_minimum;
+	static conf::item<size_t> admit_freq;
+	static conf::item<size_t> sketch_width;
 
 	database *d;
 	std::string name;
 	std::shared_ptr<struct database::stats> stats;
+	std::list<struct quota> quotas;                // root: accounting for each view
+	std::unique_ptr<struct sketch> sketch;         // root: admission frequency
+	std::shared_ptr<cache> root;                   // view: the shared cache
+	struct quota *quota {nullptr};                 // view: element of root->quotas
 	std::shared_ptr<rocksdb::Cache> c;
 
+	Priority admit(const Slice &key, const size_t &charge, const Priority &) const;
+
 	const char *Name() const noexcept override;
 	Status Insert(const Slice &key, void *value, size_t charge, deleter, Handle **, Priority) noexcept override;
 	Handle *Lookup(const Slice &key, Statistics *) noexcept override;
@@ -59,10 +91,89 @@ final
 	std::string GetPrintableOptions() const noexcept override;
 	void TEST_mark_as_data_block(const Slice &key, size_t charge) noexcept override;
 
+	// Standalone cache, or the root of a shared cache.
 	cache(database *const &,
 	      std::shared_ptr<struct database::stats>,
 	      std::string name,
-	      const ssize_t &initial_capacity = -1);
+	      const ssize_t &initial_capacity = -1,
+	      const double &hi_prio = DEFAULT_HI_PRIO);
+
+	// View of a shared cache with the soft quota for one column.
+	cache(database *const &,
+	      std::shared_ptr<struct database::stats>,
+	      std::string name,
+	      std::shared_ptr<cache> root,
+	      const size_t &capacity);
 
 	~cache() noexcept override;
 };
+
+/// Accounting for one view of a shared cache. These are held by the root
+/// and remain for its lifetime because entries of a column may outlive the
+/// column's view. The counters are updated from Insert() and the deleter,
+/// which may run on the env's kernel threads.
+struct ircd::db::database::cache::quota
+{
+	std::string name;
+	size_t capacity {0};                           // soft quota
+	std::atomic<size_t> usage {0};
+	std::atomic<size_t> count {0};
+};
+
+/// Wrapper for a value inserted through a view so the eviction from the
+/// shared LRU can be credited back to the view's quota.
+struct ircd::db::database::cache::entry
+{
+	void *value;
+	deleter del;
+	struct quota *quota;
+	size_t charge;
+
+	static void destroy(const Slice &key, void *value) noexcept;
+};
+
+/// Count-min sketch of 4-bit saturating counters estimating the recent
+/// access frequency of keys. All counters are halved after a sample period
+/// proportional to the width so the estimate favors recency. Lookups may
+/// sample from the env's kernel threads concurrently; the counters are
+/// relaxed atomics and an increment racing the halving may be lost, which
+/// only perturbs the estimate.
+struct ircd::db::database::cache::sketch
+{
+	static constexpr const size_t ROWS {4};
+	static constexpr const uint8_t MAX {15};
+
+	size_t mask;
+	size_t period;
+	std::atomic<size_t> samples {0};
+	std::vector<std::atomic<uint8_t>> counter;
+
+	size_t index(const uint64_t &hash, const size_t &row) const;
+
+  public:
+	uint8_t estimate(const uint64_t &hash) const;
+	void add(const uint64_t &hash);
+	void age();
+
+	sketch(const size_t &width);
+};
+
+/// Marks the current context as performing a read which does not fill the
+/// cache for the duration of one RocksDB call. RocksDB gives Lookup() no
+/// indication of the read options, so the mark is kept per context: the
+/// call can yield for IO and other contexts on this thread must still be
+/// sampled. Reads on the env's kernel threads are always sampled.
+struct ircd::db::database::cache::scan
+{
+	static thread_local std::vector<const ctx::ctx *> active;
+
+	bool marked {false};
+
+  public:
+	static bool current();
+
+	scan(const rocksdb::ReadOptions &);
+	scan(scan &&) = delete;
+	scan(const scan &) = delete;
+	~scan() noexcept;
+};
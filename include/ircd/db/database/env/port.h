@@ -31,6 +31,15 @@
 // unresolved symbols at link time that may be bad, and go silently unnoticed.
 //
 // !!! EXPERIMENTAL !!!
+//
+// These primitives serve two kinds of callers. The usual caller is an
+// ircd::ctx on the main thread; it queues on the ctx:: primitive and yields
+// like anything else. When the env is configured to run background jobs on
+// kernel threads (see env/state.h) those threads are also callers; they
+// cannot touch the ctx:: primitives, so each structure carries an additional
+// atomic word which is the real mutual exclusion between the two worlds. A
+// kernel thread blocks on that word with futex(2); a context never blocks the
+// event loop and instead yields until the word is released.
 
 namespace rocksdb::port
 {
@@ -46,6 +55,7 @@ class rocksdb::port::Mutex
 	friend class CondVar;
 
 	ctx::mutex mu;
+	std::atomic<uint32_t> xm {0};
 
   public:
 	void Lock() noexcept;
@@ -62,7 +72,9 @@ class rocksdb::port::Mutex
 class rocksdb::port::CondVar
 {
 	Mutex *mu;
-	ctx::condition_variable cv;
+	ctx::dock cv;
+	std::atomic<uint32_t> seq {0};
+	std::atomic<uint32_t> waiters {0};
 
   public:
 	void Wait() noexcept;
@@ -77,6 +89,7 @@ class rocksdb::port::CondVar
 class rocksdb::port::RWMutex
 {
 	ctx::shared_mutex mu;
+	std::atomic<uint32_t> xs {0};
 
   public:
 	void ReadLock() noexcept;
@@ -30,10 +30,14 @@ struct ircd::db::database::env::state
 
 struct ircd::db::database::env::state::pool
 {
+	struct workers;
+
 	using Priority = rocksdb::Env::Priority;
 	using IOPriority = rocksdb::Env::IOPriority;
 
 	static conf::item<size_t> stack_size;
+	static conf::item<size_t> threads;
+	static ios::descriptor marshal;
 
 	database &d;
 	Priority pri;
@@ -41,8 +45,10 @@ struct ircd::db::database::env::state::pool
 	ctx::dock dock;
 	uint64_t taskctr {0};
 	std::deque<task> tasks;
+	std::atomic<size_t> marshalled {0};
 	ctx::pool::opts popts;
 	ctx::pool p;
+	std::unique_ptr<struct workers> workers;
 
 	size_t cancel(void *const &tag);
 	void operator()(task &&);
@@ -61,3 +67,36 @@ struct ircd::db::database::env::state::task
 	void *arg;
 	uint64_t _id {0};
 };
+
+/// Kernel threads for a pool. When `pool::threads` is non-zero each context
+/// of the pool hands its task to one of these threads rather than executing
+/// it, then waits on the pool's dock until the completion is posted back to
+/// the main thread. Scheduling, cancellation and shutdown are still conducted
+/// by the contexts; only the execution of the job moves to another core.
+struct ircd::db::database::env::state::pool::workers
+{
+	struct work;
+
+	static ios::descriptor completion;
+
+	pool &p;
+	size_t max;
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<work> queue;
+	std::vector<std::thread> threads;
+	size_t idle {0};
+	bool terminate {false};
+
+	void worker() noexcept;
+	void operator()(const task &);
+
+	workers(pool &, const size_t &max);
+	~workers() noexcept;
+};
+
+struct ircd::db::database::env::state::pool::workers::work
+{
+	const struct task *task;
+	bool *done;
+};
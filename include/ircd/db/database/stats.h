@@ -22,8 +22,9 @@ final
 	struct passthru;
 
 	database *d {nullptr};
-	std::array<uint64_t, rocksdb::TICKER_ENUM_MAX> ticker {{0}};
+	std::array<std::atomic<uint64_t>, rocksdb::TICKER_ENUM_MAX> ticker {{0}};
 	std::array<struct db::histogram, rocksdb::HISTOGRAM_ENUM_MAX> histogram;
+	mutable std::mutex mutex;  // histogram; measured from the env's threads
 
 	uint64_t getTickerCount(const uint32_t tickerType) const noexcept override;
 	void recordTick(const uint32_t tickerType, const uint64_t count) noexcept override;
@@ -24,6 +24,7 @@ namespace ircd::db
 	struct index;
 	struct database;
 	struct options;
+	struct txn;
 
 	// db subsystem has its own logging facility
 	extern struct log::log log;
@@ -59,6 +60,7 @@ namespace ircd::db
 #include "index.h"
 #include "cell.h"
 #include "row.h"
+#include "prefetcher.h"
 #include "json.h"
 #include "txn.h"
 #include "stats.h"
@@ -89,4 +89,15 @@ struct ircd::db::descriptor
 
 	/// User given compaction callback surface.
 	db::compactor compactor {};
+
+	/// Maximum size of a compression dictionary for this column; zero
+	/// disables dictionaries. A dictionary is built from the values of each
+	/// table file as it is written, so it is retrained on every compaction.
+	/// Best with kZSTD; columns of many small, similar values benefit most
+	/// where each block alone compresses poorly.
+	size_t compression_dict_size { 0 };
+
+	/// Bytes of values sampled to train the dictionary with the zstd trainer.
+	/// When zero the sampled values are used as the dictionary directly.
+	size_t compression_dict_train { 0 };
 };
@@ -57,6 +57,7 @@ enum class ircd::db::get
 	NO_PARALLEL      = 0x0200, ///< Don't submit requests in parallel (relevant to db::row).
 	THROW            = 0x0400, ///< Throw exceptions more than usual.
 	NO_THROW         = 0x0800, ///< Suppress exceptions if possible.
+	SCAN             = 0x1000, ///< Read is part of a scan; bypass cache admission.
 };
 
 template<class T>
@@ -0,0 +1,52 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_DB_PREFETCHER_H
+
+namespace ircd::db
+{
+	struct prefetcher;
+}
+
+/// Bounded readahead window. The owner submits keys ahead of its cursor in
+/// the order they will be consumed; each is looked up on the request pool
+/// so up to `window` reads are in flight at once. As the cursor reaches a
+/// key the owner calls consume(), which accounts the prefetch as a hit if
+/// it has completed or late if it has not. Anything the cursor passes over
+/// or never reaches is accounted as wasted.
+///
+/// Consecutive submissions for the same key (i.e. several columns of a row)
+/// are grouped into one entry of the window.
+///
+struct ircd::db::prefetcher
+{
+	struct request;
+
+	size_t window {0};
+	std::deque<std::shared_ptr<request>> queue;
+
+  public:
+	bool empty() const                 { return queue.empty();                 }
+	size_t size() const                { return queue.size();                  }
+	bool full() const                  { return size() >= window;              }
+
+	bool operator()(column &, const string_view &key, const gopts & = {});
+	bool consume(const string_view &key);
+	void clear();
+
+	prefetcher(const size_t &window);
+	prefetcher() = default;
+	prefetcher(prefetcher &&) = default;
+	prefetcher(const prefetcher &) = delete;
+	prefetcher &operator=(prefetcher &&);
+	prefetcher &operator=(const prefetcher &) = delete;
+	~prefetcher() noexcept;
+};
@@ -18,8 +18,8 @@ namespace ircd::db
 	extern const uint32_t histogram_max;
 	string_view histogram_id(const uint32_t &id);
 	uint32_t histogram_id(const string_view &key);
-	const struct histogram &histogram(const database &, const uint32_t &id);
-	const struct histogram &histogram(const database &, const string_view &key);
+	struct histogram histogram(const database &, const uint32_t &id);
+	struct histogram histogram(const database &, const string_view &key);
 
 	// Ticker (per database)
 	extern const uint32_t ticker_max;
@@ -24,6 +24,9 @@ namespace ircd::db
 	bool for_each(database &d, const uint64_t &seq, const seq_closure_bool &);
 	void for_each(database &d, const uint64_t &seq, const seq_closure &);
 	void get(database &d, const uint64_t &seq, const seq_closure &);
+
+	// Commit several transactions to the same database with one write.
+	void commit(const vector_view<txn *const> &, const sopts & = {});
 }
 
 struct ircd::db::txn
@@ -60,6 +60,7 @@ namespace ircd::fs
 #include "write.h"
 #include "sync.h"
 #include "aio.h"
+#include "iou.h"
 #include "stdin.h"
 #include "support.h"
 
@@ -84,6 +85,7 @@ namespace ircd::fs
 /// Filesystem interface init / fini held by ircd::main().
 struct ircd::fs::init
 {
+	iou::init _iou_;
 	aio::init _aio_;
 
 	init();
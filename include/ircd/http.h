@@ -38,6 +38,20 @@ namespace ircd::http
 	bool has(const vector_view<const header> &, const string_view &key);
 }
 
+/// Content-Coding (RFC 7231 3.1.2). Codings are available depending on the
+/// libraries found at build time; IDENTITY is always available.
+namespace ircd::http::coding
+{
+	enum type :uint8_t;
+	struct encoder;
+
+	bool available(const type &) noexcept;
+	string_view reflect(const type &) noexcept;
+	type parse(const string_view &content_encoding);
+	type negotiate(const string_view &accept_encoding) noexcept;
+	string_view decode(const mutable_buffer &, const const_buffer &, const type &);
+}
+
 /// Root exception for HTTP.
 struct ircd::http::error
 :ircd::error
@@ -229,6 +243,8 @@ struct ircd::http::request::head
 	string_view connection;
 	string_view content_type;
 	string_view user_agent;
+	string_view accept_encoding;
+	string_view content_encoding;
 	size_t content_length {0};
 
 	string_view uri;       // full view of (path, query, fragmet)
@@ -285,6 +301,50 @@ struct ircd::http::response::chunk
 	chunk() = default;
 };
 
+enum ircd::http::coding::type
+:uint8_t
+{
+	IDENTITY,
+	GZIP,
+	ZSTD,
+	_NUM_
+};
+
+/// Streaming compressor for a single Content-Coding. Input is supplied in
+/// pieces and compressed output is passed to the closure as it is produced,
+/// in pieces no larger than the buffer given at construction. The memory
+/// held by the codec's state is bounded by the window parameter (log2 of the
+/// window size). A default-constructed or IDENTITY encoder passes input
+/// through to the closure unmodified.
+struct ircd::http::coding::encoder
+{
+	struct state;
+
+	enum flush :uint8_t
+	{
+		NONE,       ///< Codec may hold back output for better compression.
+		SYNC,       ///< All output for the input so far is produced.
+		FINISH,     ///< The stream is terminated; no further input.
+	};
+
+	using closure = std::function<void (const const_buffer &)>;
+
+	coding::type type {IDENTITY};
+	unique_buffer<mutable_buffer> buf;
+	std::unique_ptr<state> s;
+
+  public:
+	explicit operator bool() const     { return type != IDENTITY;              }
+
+	size_t operator()(const const_buffer &, const flush &, const closure &);
+
+	encoder(const coding::type &, const int &level, const int &window, const size_t &buffer_size);
+	encoder();
+	encoder(encoder &&) noexcept;
+	encoder &operator=(encoder &&) noexcept;
+	~encoder() noexcept;
+};
+
 //
 // Add more as you go...
 //
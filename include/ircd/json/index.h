@@ -0,0 +1,226 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_JSON_INDEX_H
+
+/// Member table over a json::object for repeated queries.
+///
+/// json::object re-parses its string for every query; when the same object
+/// is queried many times this device can be constructed instead. The object
+/// is iterated once and each member is recorded in a table sorted by the
+/// name_hash() of its key; lookups are then a binary search on the hash.
+/// The entries are still views into the original buffer: nothing is copied
+/// and the source must outlive the index.
+///
+/// Objects with up to MAX members are indexed without allocation; beyond
+/// that the table spills into a vector.
+///
+/// Duplicate keys resolve the same way they do with json::object. The sort
+/// is stable so members of the same name retain their source order: find()
+/// yields the first of them, and constructing a json::tuple from the index
+/// yields the last.
+///
+template<size_t MAX>
+struct ircd::json::object::index
+{
+	using entry = std::pair<name_hash_t, object::member>;
+	using const_iterator = const entry *;
+
+	json::object source;
+	size_t _count {0};
+	std::array<entry, MAX> fixed;
+	std::vector<entry> dynamic;
+
+	static bool less(const entry &a, const entry &b)
+	{
+		return a.first < b.first;
+	}
+
+  public:
+	vector_view<const entry> table() const
+	{
+		return dynamic.empty()?
+			vector_view<const entry>{fixed.data(), _count}:
+			vector_view<const entry>{dynamic};
+	}
+
+	const_iterator begin() const       { return table().begin();               }
+	const_iterator end() const         { return table().end();                 }
+	size_t count() const               { return _count;                        }
+	bool empty() const                 { return !_count;                       }
+
+	const_iterator find(const name_hash_t &key) const;
+	const_iterator find(const string_view &key) const;
+	bool has(const string_view &key) const;
+
+	// returns value or default
+	template<class T> T get(const string_view &key, const T &def = T{}) const;
+	string_view get(const string_view &key, const string_view &def = {}) const;
+
+	// returns value or throws not_found
+	template<class T = string_view> T at(const string_view &key) const;
+
+	// returns value or empty
+	string_view operator[](const string_view &key) const;
+
+	index(const json::object &source);
+	index() = default;
+};
+
+template<size_t MAX>
+ircd::json::object::index<MAX>::index(const json::object &source)
+:source{source}
+{
+	for(const auto &member : source)
+	{
+		const entry e
+		{
+			name_hash(member.first), member
+		};
+
+		if(likely(_count < MAX))
+		{
+			// Insertion into the fixed table keeps it sorted as we go; placing
+			// after any equal hash keeps the sort stable.
+			const auto pos
+			{
+				std::upper_bound(fixed.begin(), fixed.begin() + _count, e, less)
+			};
+
+			std::move_backward(pos, fixed.begin() + _count, fixed.begin() + _count + 1);
+			*pos = e;
+			++_count;
+			continue;
+		}
+
+		if(dynamic.empty())
+		{
+			dynamic.reserve(MAX * 2);
+			dynamic.assign(fixed.begin(), fixed.end());
+		}
+
+		dynamic.emplace_back(e);
+		++_count;
+	}
+
+	// Members beyond MAX were appended to the spill in source order.
+	if(!dynamic.empty())
+		std::stable_sort(dynamic.begin(), dynamic.end(), less);
+}
+
+template<size_t MAX>
+ircd::string_view
+ircd::json::object::index<MAX>::operator[](const string_view &key)
+const
+{
+	const auto it(find(key));
+	return it != end()? it->second.second : string_view{};
+}
+
+template<size_t MAX>
+template<class T>
+T
+ircd::json::object::index<MAX>::at(const string_view &key)
+const try
+{
+	const auto it(find(key));
+	if(it == end())
+		throw not_found
+		{
+			"'%s'", key
+		};
+
+	return lex_cast<T>(it->second.second);
+}
+catch(const bad_lex_cast &e)
+{
+	throw type_error
+	{
+		"'%s' must cast to type %s",
+		key,
+		typeid(T).name()
+	};
+}
+
+template<size_t MAX>
+ircd::string_view
+ircd::json::object::index<MAX>::get(const string_view &key,
+                                    const string_view &def)
+const
+{
+	const string_view sv(operator[](key));
+	return !sv.empty()? sv : def;
+}
+
+template<size_t MAX>
+template<class T>
+T
+ircd::json::object::index<MAX>::get(const string_view &key,
+                                    const T &def)
+const try
+{
+	const string_view sv(operator[](key));
+	return !sv.empty()? lex_cast<T>(sv) : def;
+}
+catch(const bad_lex_cast &e)
+{
+	return def;
+}
+
+template<size_t MAX>
+bool
+ircd::json::object::index<MAX>::has(const string_view &key)
+const
+{
+	return find(key) != end();
+}
+
+template<size_t MAX>
+typename ircd::json::object::index<MAX>::const_iterator
+ircd::json::object::index<MAX>::find(const string_view &key)
+const
+{
+	const auto table(this->table());
+	const entry e
+	{
+		name_hash(key), {}
+	};
+
+	auto it
+	{
+		std::lower_bound(table.begin(), table.end(), e, less)
+	};
+
+	for(; it != table.end() && it->first == e.first; ++it)
+		if(it->second.first == key)
+			return it;
+
+	return table.end();
+}
+
+template<size_t MAX>
+typename ircd::json::object::index<MAX>::const_iterator
+ircd::json::object::index<MAX>::find(const name_hash_t &key)
+const
+{
+	const auto table(this->table());
+	const entry e
+	{
+		key, {}
+	};
+
+	const auto it
+	{
+		std::lower_bound(table.begin(), table.end(), e, less)
+	};
+
+	return it != table.end() && it->first == key? it : table.end();
+}
@@ -31,6 +31,7 @@ namespace ircd::json
 #include "string.h"
 #include "array.h"
 #include "object.h"
+#include "index.h"
 #include "vector.h"
 #include "value.h"
 #include "member.h"
@@ -64,6 +64,7 @@ struct ircd::json::object
 {
 	struct member;
 	struct const_iterator;
+	template<size_t MAX = 32> struct index;
 
 	using key_type = string_view;
 	using mapped_type = string_view;
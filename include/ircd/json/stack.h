@@ -157,6 +157,7 @@ struct ircd::json::stack::object
   public:
 	template<class... T> void append(const json::tuple<T...> &);
 	void append(const json::object &);
+	void splice(const json::object &);
 
 	object(stack &s);                  ///< Object is top
 	object(array &pa);                 ///< Object is value in the array
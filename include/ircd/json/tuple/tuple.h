@@ -65,6 +65,7 @@ struct tuple
 	template<class... U> explicit tuple(const tuple<U...> &);
 	template<class U> explicit tuple(const json::object &, const json::keys<U> &);
 	template<class U> explicit tuple(const tuple &, const json::keys<U> &);
+	template<size_t MAX> tuple(const json::object::index<MAX> &);
 	tuple(const json::object &);
 	tuple(const json::iov &);
 	tuple(const json::members &);
@@ -189,6 +190,17 @@ tuple<T...>::tuple(const json::object &object)
 	});
 }
 
+template<class... T>
+template<size_t MAX>
+tuple<T...>::tuple(const json::object::index<MAX> &index)
+{
+	std::for_each(std::begin(index), std::end(index), [this]
+	(const auto &entry)
+	{
+		set(*this, entry.second.first, entry.second.second);
+	});
+}
+
 template<class... T>
 tuple<T...>::tuple(const json::iov &iov)
 {
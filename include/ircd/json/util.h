@@ -38,6 +38,14 @@ namespace ircd::json
 
 	// Transforms input into escaped output only
 	string_view escape(const mutable_buffer &out, const string_view &in);
+
+	// Delimits the string, object or array at the front of the input using
+	// the vectorized structural scanner; empty if it can't. This is how the
+	// object and array iterators find the end of each value. scan_isa names
+	// the instruction set compiled in. Clearing the conf item
+	// ircd.json.scan.enable reverts them to the grammar for comparison.
+	string_view scan(const string_view &) noexcept;
+	extern const string_view scan_isa;
 }
 
 /// Alternative to `json::strung` which uses a fixed array rather than an
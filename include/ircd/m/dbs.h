@@ -42,6 +42,8 @@ namespace ircd::m::dbs
 	extern db::index room_joined;      // room_id | origin, member => event_idx
 	extern db::index room_state;       // room_id | type, state_key => event_idx
 	extern db::column state_node;      // node_id => state::node
+	extern db::index room_sync;        // room_id | type, state_key => event_idx, json
+	extern db::index node_send;        // origin | event_idx => --
 
 	// Lowlevel util
 	enum class ref :uint8_t;
@@ -80,6 +82,14 @@ namespace ircd::m::dbs
 	string_view room_events_key(const mutable_buffer &out, const id::room &, const uint64_t &depth);
 	std::pair<uint64_t, event::idx> room_events_key(const string_view &amalgam);
 
+	string_view room_sync_val(const mutable_buffer &out, const event::idx &, const string_view &fragment);
+	std::tuple<event::idx, json::object> room_sync_val(const string_view &amalgam);
+
+	constexpr size_t NODE_SEND_KEY_MAX_SIZE {event::ORIGIN_MAX_SIZE + 1 + 8};
+	string_view node_send_key(const mutable_buffer &out, const string_view &origin, const event::idx &);
+	string_view node_send_key(const mutable_buffer &out, const string_view &origin);
+	event::idx node_send_key(const string_view &amalgam);
+
 	// [GET] the state root for an event (with as much information as you have)
 	string_view state_root(const mutable_buffer &out, const id::room &, const event::idx &, const uint64_t &depth);
 	string_view state_root(const mutable_buffer &out, const id::room &, const event::id &, const uint64_t &depth);
@@ -194,6 +204,9 @@ namespace ircd::m::dbs::desc
 	extern conf::item<size_t> events__content__meta_block__size;
 	extern conf::item<size_t> events__content__cache__size;
 	extern conf::item<size_t> events__content__cache_comp__size;
+	extern conf::item<std::string> events__content__compression;
+	extern conf::item<size_t> events__content__compression__dict__size;
+	extern conf::item<size_t> events__content__compression__train__size;
 	extern const db::descriptor events_content;
 
 	extern conf::item<size_t> events__depth__block__size;
@@ -256,6 +269,9 @@ namespace ircd::m::dbs::desc
 	extern conf::item<size_t> events__event_json__cache__size;
 	extern conf::item<size_t> events__event_json__cache_comp__size;
 	extern conf::item<size_t> events__event_json__bloom__bits;
+	extern conf::item<std::string> events__event_json__compression;
+	extern conf::item<size_t> events__event_json__compression__dict__size;
+	extern conf::item<size_t> events__event_json__compression__train__size;
 	extern const db::descriptor events__event_json;
 
 	// events graphing
@@ -324,6 +340,21 @@ namespace ircd::m::dbs::desc
 	extern conf::item<size_t> events__state_node__cache_comp__size;
 	extern conf::item<size_t> events__state_node__bloom__bits;
 	extern const db::descriptor events__state_node;
+
+	// room present state pre-rendered for sync
+	extern conf::item<size_t> events__room_sync__block__size;
+	extern conf::item<size_t> events__room_sync__meta_block__size;
+	extern conf::item<size_t> events__room_sync__cache__size;
+	extern conf::item<size_t> events__room_sync__cache_comp__size;
+	extern const db::prefix_transform events__room_sync__pfx;
+	extern const db::descriptor events__room_sync;
+
+	// outbound federation queue sequence
+	extern conf::item<size_t> events__node_send__block__size;
+	extern conf::item<size_t> events__node_send__meta_block__size;
+	extern conf::item<size_t> events__node_send__cache__size;
+	extern const db::prefix_transform events__node_send__pfx;
+	extern const db::descriptor events__node_send;
 }
 
 // Internal interface; not for public.
@@ -57,6 +57,7 @@ namespace ircd::m
 	bool verify(const event &, const string_view &origin, const string_view &pkid); // io/yield
 	bool verify(const event &, const string_view &origin); // io/yield
 	bool verify(const event &); // io/yield
+	size_t verify(const vector_view<const json::object> &pdus, const vector_view<bool> &mask, const bool &hash = false); // io/yield
 
 	sha256::buf hash(const event &);
 	ed25519::sig sign(const event &, const ed25519::sk &);
@@ -132,11 +133,25 @@ struct ircd::m::event
 	json::object source; // Contextual availability only.
 
 	using super_type::tuple;
+	template<size_t MAX> event(const json::object::index<MAX> &);
 	event(const json::object &);
 	event(const json::object &, const keys &);
 	event() = default;
 };
 
+template<size_t MAX>
+ircd::m::event::event(const json::object::index<MAX> &index)
+:super_type
+{
+	index
+}
+,source
+{
+	index.source
+}
+{
+}
+
 #include "event/prev.h"
 #include "event/refs.h"
 #include "event/auth.h"
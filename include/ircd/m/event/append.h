@@ -22,6 +22,12 @@ namespace ircd::m
 		const int64_t *room_depth {nullptr};
 		long age {std::numeric_limits<long>::min()};
 		bool query_txnid {true};
+		bool query_prev_state {true};
+
+		/// The event's source is exactly the serialization of its tuple
+		/// (e.g. json::strung from an m::event) and can be spliced into the
+		/// output verbatim rather than re-stringifying each member.
+		bool json_source {false};
 	};
 
 	void append(json::stack::object &, const event &, const event_append_opts & = {});
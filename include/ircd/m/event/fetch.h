@@ -33,14 +33,17 @@ struct ircd::m::event::fetch
 :event
 {
 	struct opts;
+	struct cache;
 
 	using keys = event::keys;
 	using view_closure = std::function<void (const string_view &)>;
+	using each_closure = std::function<bool (const idx &, const event &)>;
 
 	static const opts default_opts;
 
 	const opts *fopts {&default_opts};
 	idx event_idx {0};
+	std::shared_ptr<const event> cached;
 	std::array<db::cell, event::size()> cell;
 	db::cell _json;
 	db::row row;
@@ -50,6 +53,7 @@ struct ircd::m::event::fetch
 	static bool should_seek_json(const opts &);
 	bool assign_from_row(const string_view &key);
 	bool assign_from_json(const string_view &key);
+	bool assign_from_cache();
 
   public:
 	fetch(const idx &, std::nothrow_t, const opts & = default_opts);
@@ -73,8 +77,50 @@ namespace ircd::m
 
 	bool seek(event::fetch &, const event::id &, std::nothrow_t);
 	void seek(event::fetch &, const event::id &);
+
+	// Batched fetch; all events are queried from the database at once.
+	size_t seek(const vector_view<const event::idx> &, const event::fetch::each_closure &, const event::fetch::opts & = event::fetch::default_opts);
 }
 
+/// Cache of decoded events keyed by event::idx.
+///
+/// Events are immutable once written so the fully parsed m::event, and the
+/// copy of the JSON it views, can be shared by every event::fetch of the
+/// same event::idx rather than each re-reading and re-parsing it. This pays
+/// off for the events touched over and over by auth checks and state
+/// resolution (create, power levels, join rules, members).
+///
+/// An entry is entered when an event is loaded with the JSON query and is
+/// then used by both query types. The handle is a reference-counted m::event
+/// so an entry evicted while in use stays valid for its holder. A hit copies
+/// the parsed tuple and clears the members which weren't selected rather than
+/// parsing the JSON again. The cache is bounded by the memory held for each
+/// entry (the JSON plus the tuple and the bookkeeping) and evicts the least
+/// recently used. Entries are dropped when any transaction rewriting,
+/// redacting or purging the event has been committed to the database.
+///
+struct ircd::m::event::fetch::cache
+{
+	using handle = std::shared_ptr<const event>;
+
+	static const size_t overhead;
+	static conf::item<bool> enable;
+	static conf::item<size_t> size;
+	static stats::item hits;
+	static stats::item misses;
+	static size_t bytes;
+	static std::list<std::pair<idx, handle>> lru;
+	static std::unordered_map<idx, decltype(lru)::iterator> map;
+
+	static void assign(event &, const event &, const keys::selection &);
+	static handle get(const idx &);
+	static handle set(const idx &, const json::object &);
+	static size_t clear(const db::txn &);
+	static bool clear(const idx &);
+	static size_t shrink(const size_t &max);
+	static void clear();
+};
+
 /// Event Fetch Options.
 ///
 /// Refer to the individual member documentations for details. Notes:
@@ -18,4 +18,8 @@ namespace ircd::m
 
 	void prefetch(const event::id &, const event::fetch::opts & = event::fetch::default_opts);
 	void prefetch(const event::id &, const string_view &key);
+
+	// Readahead window; consume() with the same idx when it's fetched.
+	bool prefetch(db::prefetcher &, const event::idx &, const event::fetch::opts & = event::fetch::default_opts);
+	bool consume(db::prefetcher &, const event::idx &);
 }
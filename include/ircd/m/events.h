@@ -18,6 +18,8 @@ namespace ircd::m::events
 	using closure_type_bool = std::function<bool (const string_view &, const event::idx &)>;
 	using closure_sender_bool = std::function<bool (const id::user &, const event::idx &)>;
 
+	extern conf::item<size_t> prefetch_window;
+
 	bool for_each_in_type(const string_view &, const closure_type_bool &);
 	bool for_each_in_sender(const id::user &, const closure_sender_bool &);
 	bool for_each_in_origin(const string_view &, const closure_sender_bool &);
@@ -53,6 +53,13 @@ struct ircd::m::fetch::request
 	time_t finished {0};
 	std::exception_ptr eptr;
 
+	// A second request to another origin is made when the first is slower
+	// than that origin usually is; whichever completes first is used.
+	std::unique_ptr<m::v1::event> hedge;
+	unique_buffer<mutable_buffer> hedge_buf;
+	string_view hedge_origin;
+	steady_point hedge_at;
+
 	request(const m::room::id &, const m::event::id &, const size_t &bufsz = 8_KiB);
 	request(request &&) = delete;
 	request(const request &) = delete;
@@ -37,6 +37,7 @@ namespace ircd::m
 struct ircd::m::node
 {
 	struct room;
+	struct key_cache;
 	using id = m::id::node;
 	using key_closure = std::function<void (const string_view &)>;  // remember to unquote()!!!
 	using ed25519_closure = std::function<void (const ed25519::pk &)>;
@@ -74,6 +75,34 @@ struct ircd::m::node::room
 	room &operator=(const room &) = delete;
 };
 
+/// Decoded verify keys of nodes by (origin, key_id). Finding a key through
+/// m::keys queries the database, parses the key object and decodes its
+/// base64; the ed25519 overload of node::key() enters the result here so
+/// signature checks on requests and events from busy peers only cost the
+/// verification itself. Entries expire after a time so a node's keys are
+/// consulted again.
+struct ircd::m::node::key_cache
+{
+	struct entry
+	{
+		std::string origin;
+		std::string key_id;
+		ed25519::pk pk;
+		steady_point expires;
+	};
+
+	static conf::item<size_t> max;
+	static conf::item<seconds> ttl;
+	static stats::item hits;
+	static stats::item misses;
+	static std::unordered_map<size_t, entry> map;
+
+	static bool get(const string_view &origin, const string_view &key_id, const ed25519_closure &);
+	static void set(const string_view &origin, const string_view &key_id, const ed25519::pk &);
+	static bool clear(const string_view &origin, const string_view &key_id);
+	static void clear();
+};
+
 inline ircd::m::node::operator
 const ircd::m::node::id &()
 const
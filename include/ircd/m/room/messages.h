@@ -33,11 +33,22 @@ namespace ircd::m
 /// full event. One can iterate just event_idx's by using event_idx() instead
 /// of the dereference operators.
 ///
+/// Fetching keeps a window of events ahead of the cursor, in the direction
+/// it last moved, prefetching from the database; see db::prefetcher.
+///
 struct ircd::m::room::messages
 {
+	static conf::item<size_t> prefetch_window;
+
 	m::room room;
 	db::index::const_iterator it;
 	event::fetch _event;
+	db::index::const_iterator _ra;
+	db::prefetcher _prefetch;
+	bool _back {false};                // last moved by operator--
+	bool _ra_back {false};             // direction of the window
+
+	void readahead();
 
   public:
 	operator bool() const              { return bool(it);                      }
@@ -56,8 +67,8 @@ struct ircd::m::room::messages
 	bool seek(const event::id &);
 
 	// These are reversed on purpose
-	auto &operator++()                 { return --it;                          }
-	auto &operator--()                 { return ++it;                          }
+	auto &operator++()                 { _back = false; return --it;           }
+	auto &operator--()                 { _back = true; return ++it;            }
 
 	const m::event &operator*();
 	const m::event *operator->()       { return &operator*();                  }
@@ -31,21 +31,22 @@ namespace ircd::m::state
 {
 	struct name;
 	struct node;
+	struct gc;
 
 	constexpr size_t ID_MAX_SZ { 64 };
 	constexpr size_t KEY_MAX_SZ { 256 + 256 + 16 };
 	constexpr size_t VAL_MAX_SZ { 256 + 16 };
-	constexpr size_t NODE_MAX_SZ { 4_KiB };
-	constexpr size_t NODE_MAX_KEY { 2 }; // tmp for now
+	constexpr size_t NODE_MAX_SZ { 64_KiB };
+	constexpr size_t NODE_MAX_KEY { 64 };
 	constexpr size_t NODE_MAX_VAL { NODE_MAX_KEY };
-	constexpr size_t NODE_MAX_DEG { NODE_MAX_KEY + 1 }; // tmp for now
+	constexpr size_t NODE_MAX_DEG { NODE_MAX_KEY + 1 };
 	constexpr int8_t MAX_HEIGHT { 16 }; // good for few mil at any degree :)
 
 	using id = string_view;
 	using id_buffer = fixed_buffer<mutable_buffer, ID_MAX_SZ>;
 	using id_closure = std::function<void (const id &)>;
 	using val_closure = std::function<void (const string_view &)>;
-	using node_closure = std::function<void (const json::object &)>;
+	using node_closure = std::function<void (const string_view &)>;
 	using search_closure = std::function<bool (const json::array &, const string_view &, const uint &, const uint &)>;
 	using iter_closure = std::function<void (const json::array &, const string_view &)>;
 	using iter_bool_closure = std::function<bool (const json::array &, const string_view &)>;
@@ -56,7 +57,7 @@ namespace ircd::m::state
 	json::array make_key(const mutable_buffer &out, const string_view &type);
 	string_view unmake_key(const mutable_buffer &out, const json::array &);
 
-	id set_node(db::txn &txn, const mutable_buffer &id, const json::object &node);
+	id set_node(db::txn &txn, const mutable_buffer &id, const string_view &node);
 	bool get_node(const std::nothrow_t, const string_view &id, const node_closure &);
 	void get_node(const string_view &id, const node_closure &);
 
@@ -89,6 +90,53 @@ namespace ircd::m::state
 	void get(const id &root, const string_view &type, const string_view &state_key, const val_closure &);
 }
 
+/// Collection of unreachable nodes in the state_node column. Nodes are
+/// immutable and shared between trees, so nothing knows when one falls out
+/// of use. A collection marks every node reachable from the roots found in
+/// room_events; once the mark is complete the column's compaction filter
+/// drops the unmarked nodes as compaction rewrites the files, without any
+/// stop-the-world pass. There is at most one collection at gc::current.
+/// While it exists set_node() marks every node written so trees created
+/// during the collection are preserved.
+///
+/// The compaction filter runs on the database env threads, so all access
+/// to the marks is under the std::mutex rather than any ircd::ctx facility.
+/// Marks are 64-bit hashes of the node ID; a collision only keeps a dead
+/// node around. They are kept in a sorted vector at eight bytes each. New
+/// marks are staged in a small set which is merged into the vector once it
+/// reaches a fraction of the vector's size.
+struct ircd::m::state::gc
+{
+	static std::mutex mutex;
+	static gc *current;
+	static const size_t batch_min;
+	static const size_t batch_div;
+
+	std::vector<uint64_t> marks;                 // sorted
+	std::set<uint64_t> batch;                    // staged for marks
+	bool sweeping {false};
+	size_t roots {0};
+	size_t kept {0};
+	size_t swept {0};
+
+	static uint64_t hash(const id &);
+	static db::op filter(const db::compactor::args &);
+
+	bool has(const uint64_t &) const;
+	void merge();
+
+  public:
+	size_t count() const;
+	bool marked(const id &) const;
+	bool mark(const id &);
+	void sweep();
+
+	gc();
+	gc(gc &&) = delete;
+	gc(const gc &) = delete;
+	~gc() noexcept;
+};
+
 /// JSON property name strings specifically for use in m::state
 struct ircd::m::state::name
 {
@@ -98,10 +146,12 @@ struct ircd::m::state::name
 	static constexpr const char *const count {"n"};
 };
 
-/// Format for node: Node is plaintext and not binary at this time. In fact,
-/// *evil chuckle*, node might as well be JSON and can easily become content
-/// of another event sent to other rooms over network *snorts*. (important:
-/// database is well compressed).
+/// Legacy format for node (version 0): Node is plaintext and not binary. In
+/// fact, *evil chuckle*, node might as well be JSON and can easily become
+/// content of another event sent to other rooms over network *snorts*.
+/// (important: database is well compressed). New nodes are no longer written
+/// this way (see: node::bin) but existing trees remain readable; a JSON node
+/// is recognized by its leading '{'.
 ///
 /// {                                                ;
 ///     "k":                                         ; Key array
@@ -151,6 +201,7 @@ struct ircd::m::state::node
 >
 {
 	struct rep;
+	struct bin;
 
 	size_t keys() const;
 	size_t vals() const;
@@ -176,6 +227,58 @@ struct ircd::m::state::node
 	using super_type::operator=;
 };
 
+/// Binary format for node (version 1). This is a high-fanout format where a
+/// node holds up to NODE_MAX_KEY keys. Elements are reached in constant time
+/// through an offset table, so a lookup binary searches the keys in place
+/// rather than parsing the node.
+///
+/// [ head ][ cnts: u32 * cn ][ offs: u16 * (kn + kn + cn + 1) ][ data ]
+///
+/// The data section is the kn keys, then the kn values, then the cn child
+/// node IDs (empty when there's no child), back to back. Element i of the
+/// data spans offs[i] to offs[i + 1], relative to the start of the node.
+/// Keys are stored as the printed JSON array so they are viewed directly as
+/// json::array and compare with keycmp() like the legacy format. The first
+/// byte of the head is the version tag which can never be a '{'.
+struct ircd::m::state::node::bin
+{
+	struct head;
+
+	static constexpr const uint8_t FORMAT_VERSION {1};
+
+	string_view buf;
+
+	const head &header() const;
+	const uint32_t *cnts() const;
+	const uint16_t *offs() const;
+	string_view element(const size_t &) const;
+
+  public:
+	size_t keys() const;
+	size_t slots() const; // child slots including empty ones
+
+	json::array key(const size_t &) const;
+	string_view val(const size_t &) const;
+	state::id child(const size_t &) const;
+	size_t count(const size_t &) const;
+
+	size_t find(const json::array &key) const;
+
+	static bool test(const string_view &node);
+
+	bin(const string_view &node);
+};
+
+struct ircd::m::state::node::bin::head
+{
+	uint8_t version;
+	uint8_t flags;
+	uint16_t kn;
+	uint16_t cn;
+	uint16_t reserved;
+}
+__attribute__((packed));
+
 /// Internal representation of a node for manipulation purposes. This is
 /// because json::tuple's (like most of json::) are oriented around the
 /// dominant use-case of reading const datas. These arrays could be
@@ -206,10 +309,12 @@ struct ircd::m::state::node::rep
 	void shl(const size_t &pos);
 	void shr(const size_t &pos);
 
-	json::object write(const mutable_buffer &out);
+	string_view write(const mutable_buffer &out);
 	state::id write(db::txn &, const mutable_buffer &id);
 
+	rep(const string_view &node); // either format
 	rep(const node &node);
+	rep(const bin &node);
 	rep() = default;
 };
 
@@ -217,3 +322,16 @@ static_assert
 (
 	ircd::m::state::NODE_MAX_KEY == ircd::m::state::NODE_MAX_VAL
 );
+
+static_assert
+(
+	sizeof(ircd::m::state::node::bin::head) == 8
+);
+
+static_assert
+(
+	ircd::m::state::NODE_MAX_KEY * (ircd::m::state::KEY_MAX_SZ + ircd::m::state::VAL_MAX_SZ) +
+	ircd::m::state::NODE_MAX_DEG * (ircd::m::state::ID_MAX_SZ + sizeof(uint32_t) + sizeof(uint16_t) * 3) +
+	sizeof(ircd::m::state::node::bin::head) <= std::numeric_limits<uint16_t>::max(),
+	"Largest possible binary node must be addressable with 16-bit offsets."
+);
@@ -107,6 +107,7 @@ struct ircd::m::sync::data
 	int64_t room_depth {0}; // if *room
 	event::idx room_head {0}; // if *room
 	event::idx event_idx {0}; // if *event
+	bool event_source {false}; // if *event; source is its exact serialization
 	string_view client_txnid;
 
 	data(const m::user &user,
@@ -75,6 +75,7 @@ struct ircd::m::vm::eval
 	const json::iov *issue {nullptr};
 	const event *event_ {nullptr};
 	json::array pdus;
+	const bool *verified {nullptr};
 
 	string_view room_id;
 	event::id::buf event_id;
@@ -31,6 +31,8 @@ struct ircd::net::acceptor
 	static conf::item<std::string> ssl_curve_list;
 	static conf::item<std::string> ssl_cipher_list;
 	static conf::item<std::string> ssl_cipher_blacklist;
+	static conf::item<seconds> ssl_session_timeout;
+	static conf::item<seconds> ssl_ticket_rotate;
 
 	net::listener *listener_;
 	std::string name;
@@ -47,9 +49,18 @@ struct ircd::net::acceptor
 	bool handle_set {false};
 	ctx::dock joining;
 
+	// Session ticket keys; [0] issues tickets and [1] is still accepted.
+	// Each key is the 16 byte name, 32 byte HMAC key and 32 byte AES key.
+	std::mutex ticket_mutex;
+	std::array<std::array<uint8_t, 80>, 2> ticket_key;
+	size_t ticket_keys {0};
+	time_t ticket_key_time {0};
+
 	void configure(const json::object &opts);
 
 	// Handshake stack
+	void ticket_rotate();
+	int handle_ticket(SSL &, uint8_t *name, uint8_t *iv, EVP_CIPHER_CTX &, HMAC_CTX &, const int &enc);
 	bool handle_sni(SSL &, int &ad);
 	void check_handshake_error(const error_code &ec, socket &);
 	void handshake(const error_code &ec, std::shared_ptr<socket>, std::weak_ptr<acceptor>) noexcept;
@@ -50,6 +50,7 @@ namespace ircd::net
 #include "read.h"
 #include "write.h"
 #include "scope_timeout.h"
+#include "offload.h"
 
 namespace ircd::net
 {
@@ -0,0 +1,39 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_IRCD_NET_OFFLOAD_H
+
+/// TLS handshake offload.
+///
+/// The key exchange and signature operations of an SSL handshake are costly
+/// and a burst of new connections (i.e. everyone reconnecting after a
+/// restart) would otherwise saturate the main IRCd thread. With this system
+/// the handshakes of accepted and opened sockets are conducted on a pool of
+/// worker threads instead.
+///
+/// The main event loop still waits for the socket to become readable; each
+/// time the peer's next flight arrives a worker advances the handshake with
+/// non-blocking I/O until it would block again. Once the handshake completes
+/// the socket is handed back to the main thread and the usual callback is
+/// made there. Only the handshake is offloaded; the socket is not touched by
+/// any other thread after it is established.
+///
+/// The certificate verify, SNI and session ticket callbacks are made on the
+/// worker during a step; they may only touch the socket, state guarded by
+/// its own mutex, and the thread-safe logger. A timeout or disconnect while
+/// a step is on a worker is deferred until it returns. This is disabled by
+/// default.
+///
+namespace ircd::net::offload
+{
+	extern conf::item<bool> enable;
+	extern conf::item<size_t> thread_max;
+}
@@ -113,6 +113,13 @@ struct ircd::net::open_opts
 
 	/// Option to allow expired certificates.
 	bool allow_expired { default_allow_expired };
+
+	/// Client session cache for SSL session resumption. When given, the
+	/// session saved here by a prior connection is offered in the handshake
+	/// and any session issued by the remote over this connection is saved
+	/// back here for the next. Shared by all connections made with these
+	/// options; the content is the DER serialization of the session.
+	std::shared_ptr<std::string> session;
 };
 
 /// Constructor intended to provide implicit conversions (no-brackets required)
@@ -54,10 +54,12 @@ struct ircd::net::socket
 	asio::ssl::stream<ip::tcp::socket &> ssl;
 	stat in, out;
 	steady_timer timer;
+	std::shared_ptr<std::string> session;        // open_opts::session
 	uint64_t timer_sem[2] {0};                   // handler, sender
 	bool timer_set {false};                      // boolean lockout
 	bool timedout {false};
 	bool fini {false};
+	bool offloaded {false};                      // handshake step on offload thread
 
 	void call_user(const eptr_handler &, const error_code &) noexcept;
 	void call_user(const ec_handler &, const error_code &) noexcept;
@@ -17,6 +17,7 @@
 struct ssl_st;
 struct ssl_ctx_st;
 struct ssl_cipher_st;
+struct ssl_session_st;
 struct rsa_st;
 struct x509_st;
 struct x509_store_ctx_st;
@@ -43,6 +44,7 @@ namespace ircd::openssl
 	using SSL = ::ssl_st;
 	using SSL_CTX = ::ssl_ctx_st;
 	using SSL_CIPHER = ::ssl_cipher_st;
+	using SSL_SESSION = ::ssl_session_st;
 	using RSA = ::rsa_st;
 	using X509 = ::x509_st;
 	using X509_STORE_CTX = ::x509_store_ctx_st;
@@ -141,6 +143,11 @@ namespace ircd::openssl
 	// SNI suite
 	string_view server_name(const SSL &); // provided by client
 	void server_name(SSL &, const string_view &); // set by client
+
+	// Session suite
+	bool session_reused(const SSL &);
+	std::string session(const SSL_SESSION &); // DER; empty if not resumable
+	bool session(SSL &, const const_buffer &der); // false if not usable
 }
 
 /// OpenSSL BIO convenience utils and wraps; also secure file IO closures
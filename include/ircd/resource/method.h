@@ -16,10 +16,13 @@ struct ircd::resource::method
 	enum flag :uint;
 	struct opts;
 	struct stats;
+	struct token_cache;
 	using handler = std::function<response (client &, request &)>;
 
 	static conf::item<bool> x_matrix_verify_origin;
 	static conf::item<bool> x_matrix_verify_destination;
+	static ircd::stats::item x_matrix_verified;
+	static ircd::stats::item x_matrix_invalid;
 	static ctx::dock idle_dock;
 
 	struct resource *resource;
@@ -31,6 +34,7 @@ struct ircd::resource::method
 
 	string_view verify_origin(client &, request &) const;
 	string_view authenticate(client &, request &) const;
+	string_view decode_content(client &, const http::request::head &, const string_view &) const;
 	void handle_timeout(client &) const;
 	void call_handler(client &, request &);
 
@@ -75,3 +79,38 @@ struct ircd::resource::method::stats
 	uint64_t completions {0};         // The handler returned without throwing.
 	uint64_t internal_errors {0};     // The handler threw a very bad exception.
 };
+
+/// Access tokens resolved by authenticate() are held here so most requests
+/// don't query the tokens room. The table is keyed by a hash of the token
+/// and the token is kept in the entry to confirm a match. Tokens found to be
+/// invalid are also entered for a short time so they can't be used to make
+/// a query on every request. Entries are dropped when the token is issued or
+/// redacted by hooks on the tokens room (see m_user), and all entries expire
+/// so a missed invalidation cannot last. A lookup which yielded across an
+/// invalidation is not entered; the generation is taken before the lookup
+/// and compared before set().
+struct ircd::resource::method::token_cache
+{
+	struct entry
+	{
+		std::string token;
+		m::user::id::buf user_id;        // empty when the token is invalid
+		steady_point expires;
+	};
+
+	static conf::item<size_t> max;
+	static conf::item<seconds> ttl;
+	static conf::item<size_t> negative_max;
+	static conf::item<seconds> negative_ttl;
+	static ircd::stats::item hits;
+	static ircd::stats::item misses;
+	static ircd::stats::item negative_hits;
+	static std::unordered_map<size_t, entry> map;
+	static size_t negatives;
+	static uint64_t generation;           // incremented by each clear()
+
+	static const entry *find(const string_view &token);
+	static void set(const string_view &token, const string_view &user_id);
+	static bool clear(const string_view &token);
+	static void clear();
+};
@@ -17,6 +17,16 @@ struct ircd::resource::response
 
 	static const size_t HEAD_BUF_SZ;
 	static conf::item<std::string> access_control_allow_origin;
+	static conf::item<bool> encoding_enable;
+	static conf::item<size_t> encoding_min_size;
+	static conf::item<size_t> encoding_buffer_size;
+	static conf::item<size_t> encoding_window;
+	static conf::item<int> encoding_gzip_level;
+	static conf::item<int> encoding_zstd_level;
+	static stats::item encoding_bytes_in;
+	static stats::item encoding_bytes_out;
+
+	static http::coding::type encoding(const client &, const string_view &content_type, const string_view &headers);
 
 	response(client &, const http::code &, const string_view &content_type, const size_t &content_length, const string_view &headers = {});
 	response(client &, const string_view &str, const string_view &content_type, const http::code &, const vector_view<const http::header> &);
@@ -40,7 +50,9 @@ struct ircd::resource::response::chunked
 
 	client *c {nullptr};
 	unique_buffer<mutable_buffer> buf;
+	http::coding::encoder encoder;
 
+	size_t write_chunk(const const_buffer &chunk);
 	size_t write(const const_buffer &chunk, const bool &ignore_empty = true);
 	const_buffer flush(const const_buffer &);
 	bool finish();
@@ -51,6 +63,7 @@ struct ircd::resource::response::chunked
 	chunked(client &, const http::code &, const string_view &content_type, const vector_view<const http::header> &, const size_t &buffer_size = default_buffer_size);
 	chunked(client &, const http::code &, const vector_view<const http::header> &, const size_t &buffer_size = default_buffer_size);
 	chunked(client &, const http::code &, const size_t &buffer_size = default_buffer_size);
+	chunked(client &, const http::code &, const string_view &content_type, const string_view &headers, const size_t &buffer_size, const http::coding::type &);
 	chunked(const chunked &) = delete;
 	chunked(chunked &&) = delete;
 	chunked() = default;
@@ -23,10 +23,12 @@ struct ircd::server::peer
 	struct err;
 
 	static constexpr const size_t &LINK_MAX{16};
+	static constexpr const size_t &SCORE_SAMPLES{64};
 	static conf::item<bool> enable_ipv6;
 	static conf::item<size_t> link_min_default;
 	static conf::item<size_t> link_max_default;
 	static conf::item<seconds> error_clear_default;
+	static conf::item<size_t> score_errors_max;
 	static uint64_t ids;
 
 	uint64_t id {++ids};
@@ -39,6 +41,10 @@ struct ircd::server::peer
 	std::string server_version;
 	size_t write_bytes {0};
 	size_t read_bytes {0};
+	std::array<uint32_t, SCORE_SAMPLES> score_latency {{0}}; // ring of recent (ms)
+	size_t score_count {0};
+	size_t score_errors {0};
+	size_t score_errors_consecutive {0};
 	bool op_resolve {false};
 	bool op_fini {false};
 
@@ -57,6 +63,9 @@ struct ircd::server::peer
 	void disperse(link &);
 	void del(link &);
 
+	void score_done(const tag &);
+	void score_error();
+
 	void handle_head_recv(const link &, const tag &, const http::response::head &);
 	void handle_link_done(link &);
 	void handle_tag_done(link &, tag &) noexcept;
@@ -99,6 +108,10 @@ struct ircd::server::peer
 	size_t write_total() const;
 	size_t read_total() const;
 
+	// scoreboard of recent responses from the remote
+	milliseconds latency(const double &percentile = 0.50) const;
+	bool healthy() const;
+
 	// link control panel
 	link &link_add(const size_t &num = 1);
 	link *link_get(const request &);
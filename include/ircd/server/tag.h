@@ -39,6 +39,7 @@ struct ircd::server::tag
 		size_t chunk_read {0};         // content read after last chunk head
 		size_t chunk_length {0};       // -1 for chunk header mode
 		http::code status {(http::code)0};
+		steady_point sent;             // time of first write to remote
 	}
 	state;
 	ctx::promise<http::code> p;
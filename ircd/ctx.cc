@@ -758,20 +758,25 @@ noexcept(false)
 // uninterruptible::nothrow
 //
 
+// This device is also constructed by code which may be entered by a foreign
+// std::thread (e.g. the database env) where there is no context to modify;
+// it has no effect in that case.
 ircd::ctx::this_ctx::uninterruptible::nothrow::nothrow()
 noexcept
 :theirs
 {
-	interruptible(cur())
+	!current || interruptible(cur())
 }
 {
-	interruptible(false, std::nothrow);
+	if(likely(current))
+		interruptible(false, std::nothrow);
 }
 
 ircd::ctx::this_ctx::uninterruptible::nothrow::~nothrow()
 noexcept
 {
-	interruptible(theirs, std::nothrow);
+	if(likely(current))
+		interruptible(theirs, std::nothrow);
 }
 
 //
@@ -1936,20 +1941,89 @@ ircd::ctx::prof::reflect(const event &e)
 
 namespace ircd::ctx::ole
 {
-	using closure = std::function<void ()>;
+	struct job;
+	struct ring;
+	struct worker;
 
-	extern conf::item<size_t> thread_max;
+	static constexpr const size_t &THREADS_MAX
+	{
+		64
+	};
+
+	extern stats::item stats_submit;
+	extern stats::item stats_batch;
+	extern stats::item stats_complete;
+	extern stats::item stats_steal;
+	extern stats::item stats_queued;
+	extern stats::item stats_threads;
+	extern stats::item stats_latency_queue;
+	extern stats::item stats_latency_exec;
+	extern stats::item stats_latency_total;
 
 	std::mutex mutex;
 	std::condition_variable cond;
-	bool termination;
-	std::deque<closure> queue;
-	std::vector<std::thread> threads;
+	std::atomic<bool> termination;
+	std::atomic<size_t> sleeping;
+	std::atomic<size_t> workers_num;
+	std::array<std::unique_ptr<worker>, THREADS_MAX> workers;
+	size_t next;
+
+	static uint64_t now() noexcept;
+	static bool available() noexcept;
+	static void execute(job &) noexcept;
+	static void complete(job &) noexcept;
+	static void wake(const size_t &count);
+	static void submit(job &);
+	static void spawn();
+	static void offload(job *const &, const size_t &count);
+}
+
+/// A unit of work; lives on the stack (or in the batch) of the submitting
+/// context which cannot leave until the job has completed.
+struct ircd::ctx::ole::job
+{
+	const closure *func {nullptr};
+	ctx *context {nullptr};
+	size_t *remain {nullptr};
+	std::exception_ptr eptr;
+	uint64_t submitted {0};
+	uint64_t started {0};
+	uint64_t finished {0};
+	bool stolen {false};
+};
 
-	closure pop();
-	void push(closure &&);
-	void worker() noexcept;
-}
+/// Bounded single-producer multi-consumer ring. The producer is always the
+/// main thread; consumers are the owning worker and any stealing worker.
+struct ircd::ctx::ole::ring
+{
+	static constexpr const size_t SIZE
+	{
+		256
+	};
+
+	alignas(64) std::atomic<uint64_t> head {0};
+	alignas(64) std::atomic<uint64_t> tail {0};
+	std::array<std::atomic<job *>, SIZE> slot;
+
+	size_t size() const noexcept;
+	job *pop() noexcept;
+	bool push(job &) noexcept;
+};
+
+struct ircd::ctx::ole::worker
+{
+	size_t id;
+	ring queue;
+	std::thread thread;
+
+	static long cpu(const size_t &id);
+
+	job *take() noexcept;
+	void main() noexcept;
+
+	worker(const size_t &id);
+	~worker() noexcept;
+};
 
 decltype(ircd::ctx::ole::thread_max)
 ircd::ctx::ole::thread_max
@@ -1958,9 +2032,76 @@ ircd::ctx::ole::thread_max
 	{ "default",  int64_t(1)                 },
 };
 
+/// Space separated list of CPU numbers. Worker N is pinned to the Nth CPU
+/// (wrapping around) when it is spawned. Empty for no pinning.
+decltype(ircd::ctx::ole::thread_affinity)
+ircd::ctx::ole::thread_affinity
+{
+	{ "name",     "ircd.ctx.ole.thread.affinity" },
+	{ "default",  string_view{}                  },
+};
+
+decltype(ircd::ctx::ole::stats_submit)
+ircd::ctx::ole::stats_submit
+{
+	{ "name", "ircd.ctx.ole.submit" },
+};
+
+decltype(ircd::ctx::ole::stats_batch)
+ircd::ctx::ole::stats_batch
+{
+	{ "name", "ircd.ctx.ole.batch" },
+};
+
+decltype(ircd::ctx::ole::stats_complete)
+ircd::ctx::ole::stats_complete
+{
+	{ "name", "ircd.ctx.ole.complete" },
+};
+
+decltype(ircd::ctx::ole::stats_steal)
+ircd::ctx::ole::stats_steal
+{
+	{ "name", "ircd.ctx.ole.steal" },
+};
+
+decltype(ircd::ctx::ole::stats_queued)
+ircd::ctx::ole::stats_queued
+{
+	{ "name", "ircd.ctx.ole.queued" },
+};
+
+decltype(ircd::ctx::ole::stats_threads)
+ircd::ctx::ole::stats_threads
+{
+	{ "name", "ircd.ctx.ole.threads" },
+};
+
+/// Nanoseconds accumulated between submission and a worker starting the job.
+decltype(ircd::ctx::ole::stats_latency_queue)
+ircd::ctx::ole::stats_latency_queue
+{
+	{ "name", "ircd.ctx.ole.latency.queue" },
+};
+
+/// Nanoseconds accumulated executing jobs on the workers.
+decltype(ircd::ctx::ole::stats_latency_exec)
+ircd::ctx::ole::stats_latency_exec
+{
+	{ "name", "ircd.ctx.ole.latency.exec" },
+};
+
+/// Nanoseconds accumulated between submission and the completion being
+/// received back on the main thread.
+decltype(ircd::ctx::ole::stats_latency_total)
+ircd::ctx::ole::stats_latency_total
+{
+	{ "name", "ircd.ctx.ole.latency.total" },
+};
+
 ircd::ctx::ole::init::init()
 {
-	assert(threads.empty());
+	assert(!workers_num);
 	termination = false;
 }
 
@@ -1970,39 +2111,49 @@ noexcept
 	std::unique_lock lock(mutex);
 	termination = true;
 	cond.notify_all();
-	cond.wait(lock, []
-	{
-		return threads.empty();
-	});
+	lock.unlock();
+
+	const size_t num(workers_num);
+	for(size_t i(0); i < num; ++i)
+		workers[i].reset();
+
+	workers_num = 0;
+	stats_threads = 0;
 }
 
 void
-ircd::ctx::ole::offload(const std::function<void ()> &func)
+ircd::ctx::ole::offload(const closure &func)
 {
-	bool done(false);
-	auto *const context(current);
-	const auto kick([&context, &done]
-	{
-		done = true;
-		notify(*context);
-	});
+	job job;
+	job.func = &func;
+	offload(&job, 1);
+}
 
-	std::exception_ptr eptr;
-	auto closure([&func, &eptr, &context, &kick]
-	() noexcept
-	{
-		try
-		{
-			func();
-		}
-		catch(...)
-		{
-			eptr = std::current_exception();
-		}
+void
+ircd::ctx::ole::offload(const vector_view<const closure> &funcs)
+{
+	if(unlikely(funcs.empty()))
+		return;
 
-		// To wake the context on the IRCd thread we give it the kick
-		signal(*context, kick);
-	});
+	std::vector<job> jobs(funcs.size());
+	for(size_t i(0); i < funcs.size(); ++i)
+		jobs[i].func = &funcs[i];
+
+	stats_batch += 1;
+	offload(jobs.data(), jobs.size());
+}
+
+void
+ircd::ctx::ole::offload(job *const &jobs,
+                        const size_t &count)
+{
+	assert(current);
+	size_t remain(count);
+	for(size_t i(0); i < count; ++i)
+	{
+		jobs[i].context = current;
+		jobs[i].remain = &remain;
+	}
 
 	// interrupt(ctx) is suppressed while this context has offloaded some work
 	// to another thread. This context must stay right here and not disappear
@@ -2010,74 +2161,304 @@ ircd::ctx::ole::offload(const std::function<void ()> &func)
 	// capable of throwing an interrupt that was received during this scope.
 	const uninterruptible uninterruptible;
 
-	push(std::move(closure)); do
+	for(size_t i(0); i < count; ++i)
+		submit(jobs[i]);
+
+	wake(count); do
 	{
 		wait();
 	}
-	while(!done);
+	while(remain);
 
 	// Don't throw any exception if there is a pending interrupt for this ctx.
 	// Two exceptions will be thrown in that case and if there's an interrupt
 	// we don't care about eptr anyway.
-	if(eptr && likely(!interruption_requested()))
-		std::rethrow_exception(eptr);
+	if(likely(!interruption_requested()))
+		for(size_t i(0); i < count; ++i)
+			if(jobs[i].eptr)
+				std::rethrow_exception(jobs[i].eptr);
 }
 
+/// Place the job on a worker's ring; round-robin with overflow to the next
+/// ring. If every ring is full the context yields until space is available.
 void
-ircd::ctx::ole::push(closure &&func)
+ircd::ctx::ole::submit(job &job)
 {
-	if(unlikely(threads.size() < size_t(thread_max)))
-		threads.emplace_back(&worker);
+	assert(is_main_thread());
+	if(!sleeping && workers_num < std::min(size_t(thread_max), THREADS_MAX))
+		spawn();
+
+	if(unlikely(!workers_num))
+		throw error
+		{
+			"No offload threads available (ircd.ctx.ole.thread.max=%zu)",
+			size_t(thread_max)
+		};
+
+	job.submitted = now();
+	for(size_t i(0);; ++i)
+	{
+		const size_t num(workers_num);
+		auto &worker(*workers[next++ % num]);
+		if(likely(worker.queue.push(job)))
+			break;
+
+		if(i % num == num - 1)
+		{
+			wake(num);
+			yield();
+		}
+	}
+
+	stats_submit += 1;
+	stats_queued += 1;
+}
+
+void
+ircd::ctx::ole::spawn()
+{
+	const size_t id(workers_num);
+	assert(id < THREADS_MAX);
+	workers[id] = std::make_unique<worker>(id);
+	workers_num.store(id + 1, std::memory_order_release);
+	stats_threads = id + 1;
+}
+
+void
+ircd::ctx::ole::wake(const size_t &count)
+{
+	if(!sleeping)
+		return;
 
 	const std::lock_guard lock(mutex);
-	queue.emplace_back(std::move(func));
-	cond.notify_all();
+	if(count > 1)
+		cond.notify_all();
+	else
+		cond.notify_one();
 }
 
+/// Executed on a worker thread.
 void
-ircd::ctx::ole::worker()
-noexcept try
+ircd::ctx::ole::execute(job &job)
+noexcept
 {
-	while(1)
+	job.started = now();
+	try
+	{
+		assert(job.func);
+		(*job.func)();
+	}
+	catch(...)
 	{
-		const auto func(pop());
-		func();
+		job.eptr = std::current_exception();
 	}
+
+	job.finished = now();
+
+	// To wake the context on the IRCd thread we give it the kick. The job
+	// must not be touched by this thread after this point.
+	auto &context(*job.context);
+	signal(context, [&job]
+	{
+		complete(job);
+	});
+}
+
+/// Executed on the main thread with the completed job.
+void
+ircd::ctx::ole::complete(job &job)
+noexcept
+{
+	const auto received(now());
+	stats_queued -= 1;
+	stats_complete += 1;
+	stats_steal += job.stolen;
+	stats_latency_queue += job.started - job.submitted;
+	stats_latency_exec += job.finished - job.started;
+	stats_latency_total += received - job.submitted;
+
+	assert(job.remain && *job.remain > 0);
+	if(!--*job.remain)
+		notify(*job.context);
 }
-catch(const interrupted &)
+
+bool
+ircd::ctx::ole::available()
+noexcept
 {
-	std::unique_lock lock(mutex);
-	const auto it(std::find_if(begin(threads), end(threads), []
-	(const auto &thread)
+	const size_t num(workers_num.load(std::memory_order_acquire));
+	for(size_t i(0); i < num; ++i)
+		if(workers[i]->queue.size())
+			return true;
+
+	return false;
+}
+
+uint64_t
+ircd::ctx::ole::now()
+noexcept
+{
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//
+// ole::worker
+//
+
+/// The affinity is resolved before the thread is started so nothing can
+/// throw while a joinable thread is held by a partially constructed worker.
+ircd::ctx::ole::worker::worker(const size_t &id)
+:id{id}
+{
+	const long cpu
 	{
-		return thread.get_id() == std::this_thread::get_id();
-	}));
+		worker::cpu(id)
+	};
 
-	assert(it != end(threads));
-	auto &this_thread(*it);
-	this_thread.detach();
-	threads.erase(it);
-	cond.notify_all();
+	thread = std::thread
+	{
+		&worker::main, this
+	};
+
+	if(cpu < 0)
+		return;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if(const int err = ::pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set); err)
+		log::error
+		{
+			"ole worker:%zu failed to set affinity to cpu:%ld :%s",
+			id,
+			cpu,
+			std::error_code(err, std::system_category()).message(),
+		};
+}
+
+ircd::ctx::ole::worker::~worker()
+noexcept
+{
+	assert(termination);
+	if(thread.joinable())
+		thread.join();
 }
 
-ircd::ctx::ole::closure
-ircd::ctx::ole::pop()
+/// The CPU worker `id` is pinned to from ircd.ctx.ole.thread.affinity, or -1
+/// for none. Tokens which aren't a CPU number below CPU_SETSIZE are logged
+/// and skipped.
+long
+ircd::ctx::ole::worker::cpu(const size_t &id)
 {
-	std::unique_lock lock(mutex);
-	cond.wait(lock, []
+	const string_view &affinity(thread_affinity);
+	std::vector<long> cpus;
+	tokens(affinity, ' ', [&cpus, &id](const string_view &token)
 	{
-		if(!queue.empty())
-			return true;
+		if(try_lex_cast<uint>(token) && lex_cast<uint>(token) < CPU_SETSIZE)
+		{
+			cpus.emplace_back(lex_cast<uint>(token));
+			return;
+		}
+
+		log::warning
+		{
+			"ole worker:%zu ignoring invalid cpu '%s' in ircd.ctx.ole.thread.affinity",
+			id,
+			token,
+		};
+	});
+
+	return !cpus.empty()?
+		cpus.at(id % cpus.size()):
+		-1L;
+}
+
+void
+ircd::ctx::ole::worker::main()
+noexcept
+{
+	while(1)
+	{
+		if(auto *const job{take()})
+		{
+			execute(*job);
+			continue;
+		}
+
+		std::unique_lock lock(mutex);
+		++sleeping;
+		cond.wait(lock, []
+		{
+			return termination || available();
+		});
+
+		--sleeping;
+		if(termination && !available())
+			return;
+	}
+}
+
+/// Take work from this worker's ring; otherwise steal from the others.
+ircd::ctx::ole::job *
+ircd::ctx::ole::worker::take()
+noexcept
+{
+	if(auto *const job{queue.pop()})
+		return job;
 
-		if(unlikely(termination))
-			throw interrupted{};
+	const size_t num(workers_num.load(std::memory_order_acquire));
+	for(size_t i(1); i < num; ++i)
+		if(auto *const job{workers[(id + i) % num]->queue.pop()})
+		{
+			job->stolen = true;
+			return job;
+		}
 
+	return nullptr;
+}
+
+//
+// ole::ring
+//
+
+/// Producer side; main thread only.
+bool
+ircd::ctx::ole::ring::push(job &job)
+noexcept
+{
+	const auto t(tail.load(std::memory_order_relaxed));
+	if(t - head.load(std::memory_order_acquire) >= SIZE)
 		return false;
-	});
 
-	auto c(std::move(queue.front()));
-	queue.pop_front();
-	return std::move(c);
+	slot[t % SIZE].store(&job, std::memory_order_relaxed);
+	tail.store(t + 1, std::memory_order_seq_cst);
+	return true;
+}
+
+/// Consumer side; any worker. A consumer claims the job at `head` by
+/// advancing it; the slot can only be reused by the producer after that.
+ircd::ctx::ole::job *
+ircd::ctx::ole::ring::pop()
+noexcept
+{
+	auto h(head.load(std::memory_order_acquire));
+	while(h < tail.load(std::memory_order_acquire))
+	{
+		auto *const job(slot[h % SIZE].load(std::memory_order_relaxed));
+		if(head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel))
+			return job;
+	}
+
+	return nullptr;
+}
+
+size_t
+ircd::ctx::ole::ring::size()
+const noexcept
+{
+	const auto t(tail.load(std::memory_order_seq_cst));
+	const auto h(head.load(std::memory_order_acquire));
+	return t > h? t - h : 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
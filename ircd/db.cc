@@ -469,7 +469,10 @@ ircd::db::resume(database &d)
 		d.d->Resume()
 	};
 
-	d.errors.clear();
+	{
+		const std::lock_guard lock{d.errors_mutex};
+		d.errors.clear();
+	}
 
 	log::info
 	{
@@ -788,9 +791,14 @@ ircd::db::files(const database &cd,
 	return ret;
 }
 
-const std::vector<std::string> &
+std::vector<std::string>
 ircd::db::errors(const database &d)
 {
+	const std::lock_guard lock
+	{
+		d.errors_mutex
+	};
+
 	return d.errors;
 }
 
@@ -1043,6 +1051,12 @@ try
 {
 	std::make_shared<database::cache>(this, this->stats, this->name, 16_MiB)
 }
+,block_cache
+{
+	bool(database::cache::shared_enable)?
+		std::make_shared<database::cache>(this, this->stats, this->name, 0, database::cache::shared_hi_prio):
+		nullptr
+}
 ,descriptors
 {
 	std::move(description)
@@ -1074,6 +1088,12 @@ try
 	opts->max_background_flushes = 1;
 	opts->max_background_compactions = 1;
 
+	// When the env executes background jobs on kernel threads there is no
+	// thread_local hazard; compactions can proceed concurrently up to the
+	// number of threads given to the pool.
+	if(size_t(database::env::state::pool::threads) > 1)
+		opts->max_background_compactions = size_t(database::env::state::pool::threads);
+
 	opts->max_total_wal_size = 32_MiB; //TODO: conf
 	opts->db_write_buffer_size = 32_MiB; //TODO: conf
 	//opts->max_log_file_size = 32_MiB; //TODO: conf
@@ -1795,11 +1815,16 @@ ircd::db::database::column::column(database &d,
 
 	// Compression options
 	this->options.compression_opts.enabled = true;
-	this->options.compression_opts.max_dict_bytes = 0;//8_MiB;
+	this->options.compression_opts.max_dict_bytes = this->descriptor->compression_dict_size;
+	this->options.compression_opts.zstd_max_train_bytes = this->descriptor->compression_dict_train;
 
-	// Mimic the above for bottommost compression.
-	//this->options.bottommost_compression = this->options.compression;
-	//this->options.bottommost_compression_opts = this->options.compression_opts;
+	// Mimic the above for bottommost compression so the dictionary applies
+	// at every level.
+	if(this->descriptor->compression_dict_size)
+	{
+		this->options.bottommost_compression = this->options.compression;
+		this->options.bottommost_compression_opts = this->options.compression_opts;
+	}
 
 	//TODO: descriptor / conf
 	this->options.disable_auto_compactions = false;
@@ -1852,8 +1877,12 @@ ircd::db::database::column::column(database &d,
 	table_opts.block_align = this->options.compression == rocksdb::kNoCompression;
 
 	// Setup the cache for assets.
+	// The column draws from the database's shared cache with its size as a
+	// quota when that is available; otherwise it has a cache of its own.
 	const auto &cache_size(this->descriptor->cache_size);
-	if(cache_size != 0)
+	if(cache_size != 0 && this->d->block_cache)
+		table_opts.block_cache = std::make_shared<database::cache>(this->d, this->stats, this->name, this->d->block_cache, cache_size);
+	else if(cache_size != 0)
 		table_opts.block_cache = std::make_shared<database::cache>(this->d, this->stats, this->name, cache_size);
 
 	// RocksDB will create an 8_MiB block_cache if we don't create our own.
@@ -1882,7 +1911,7 @@ ircd::db::database::column::column(database &d,
 
 	log::debug
 	{
-		log, "schema '%s' column [%s => %s] cmp[%s] pfx[%s] lru:%s:%s bloom:%zu compression:%d %s",
+		log, "schema '%s' column [%s => %s] cmp[%s] pfx[%s] lru:%s:%s bloom:%zu compression:%d dict:%zu %s",
 		db::name(d),
 		demangle(key_type.name()),
 		demangle(mapped_type.name()),
@@ -1892,6 +1921,7 @@ ircd::db::database::column::column(database &d,
 		cache_size_comp? "YES": "NO",
 		bloom_bits,
 		int(this->options.compression),
+		this->descriptor->compression_dict_size,
 		this->descriptor->name
 	};
 }
@@ -2392,17 +2422,22 @@ ircd::db::ticker_max
 // histogram
 //
 
-const struct ircd::db::histogram &
+struct ircd::db::histogram
 ircd::db::histogram(const database &d,
                     const string_view &key)
 {
 	return histogram(d, histogram_id(key));
 }
 
-const struct ircd::db::histogram &
+struct ircd::db::histogram
 ircd::db::histogram(const database &d,
                     const uint32_t &id)
 {
+	const std::lock_guard lock
+	{
+		d.stats->mutex
+	};
+
 	return d.stats->histogram.at(id);
 }
 
@@ -2458,7 +2493,10 @@ rocksdb::Status
 ircd::db::database::stats::Reset()
 noexcept
 {
-	ticker.fill(0);
+	for(auto &count : ticker)
+		count.store(0, std::memory_order_relaxed);
+
+	const std::lock_guard lock{mutex};
 	histogram.fill({0.0});
 	return rocksdb::Status::OK();
 }
@@ -2467,9 +2505,7 @@ uint64_t
 ircd::db::database::stats::getAndResetTickerCount(const uint32_t type)
 noexcept
 {
-	const auto ret(getTickerCount(type));
-	setTickerCount(type, 0);
-	return ret;
+	return ticker.at(type).exchange(0, std::memory_order_relaxed);
 }
 
 bool
@@ -2484,6 +2520,7 @@ ircd::db::database::stats::measureTime(const uint32_t type,
                                        const uint64_t time)
 noexcept
 {
+	const std::lock_guard lock{mutex};
 	auto &data(histogram.at(type));
 
 	data.time += time;
@@ -2499,6 +2536,7 @@ ircd::db::database::stats::histogramData(const uint32_t type,
 const noexcept
 {
 	assert(data);
+	const std::lock_guard lock{mutex};
 	const auto &h
 	{
 		histogram.at(type)
@@ -2517,7 +2555,7 @@ ircd::db::database::stats::recordTick(const uint32_t type,
                                       const uint64_t count)
 noexcept
 {
-	ticker.at(type) += count;
+	ticker.at(type).fetch_add(count, std::memory_order_relaxed);
 }
 
 void
@@ -2525,14 +2563,14 @@ ircd::db::database::stats::setTickerCount(const uint32_t type,
                                           const uint64_t count)
 noexcept
 {
-	ticker.at(type) = count;
+	ticker.at(type).store(count, std::memory_order_relaxed);
 }
 
 uint64_t
 ircd::db::database::stats::getTickerCount(const uint32_t type)
 const noexcept
 {
-	return ticker.at(type);
+	return ticker.at(type).load(std::memory_order_relaxed);
 }
 
 //
@@ -2649,7 +2687,7 @@ noexcept
 		info.file_path,
 	};
 
-	assert(info.thread_id == ctx::id(*ctx::current));
+	assert(!ctx::current || info.thread_id == ctx::id(*ctx::current));
 }
 
 void
@@ -2671,7 +2709,7 @@ noexcept
 		info.cf_name,
 	};
 
-	assert(info.thread_id == ctx::id(*ctx::current));
+	assert(!ctx::current || info.thread_id == ctx::id(*ctx::current));
 }
 
 void
@@ -2734,7 +2772,7 @@ noexcept
 			info.stats.num_corrupt_keys
 		};
 
-	assert(info.thread_id == ctx::id(*ctx::current));
+	assert(!ctx::current || info.thread_id == ctx::id(*ctx::current));
 }
 
 void
@@ -2913,6 +2951,12 @@ noexcept
 			*status = rocksdb::Status(*status, rocksdb::Status::kHardError);
 
 	// Save the error string to the database instance for later examination.
+	// This is called on the env's kernel threads as well as the main thread.
+	const std::lock_guard lock
+	{
+		d->errors_mutex
+	};
+
 	d->errors.emplace_back(str);
 }
 
@@ -2953,6 +2997,44 @@ ircd::db::database::cache::DEFAULT_HI_PRIO
 	0.10
 };
 
+decltype(ircd::db::database::cache::shared_enable)
+ircd::db::database::cache::shared_enable
+{
+	{ "name",     "ircd.db.cache.shared.enable" },
+	{ "default",  true                          },
+	{ "persist",  false                         },
+};
+
+decltype(ircd::db::database::cache::shared_hi_prio)
+ircd::db::database::cache::shared_hi_prio
+{
+	{ "name",     "ircd.db.cache.shared.hi_prio" },
+	{ "default",  0.75                           },
+	{ "persist",  false                          },
+};
+
+decltype(ircd::db::database::cache::shared_minimum)
+ircd::db::database::cache::shared_minimum
+{
+	{ "name",     "ircd.db.cache.shared.minimum" },
+	{ "default",  0.25                           },
+};
+
+decltype(ircd::db::database::cache::admit_freq)
+ircd::db::database::cache::admit_freq
+{
+	{ "name",     "ircd.db.cache.admit.freq" },
+	{ "default",  2L                         },
+};
+
+decltype(ircd::db::database::cache::sketch_width)
+ircd::db::database::cache::sketch_width
+{
+	{ "name",     "ircd.db.cache.sketch.width" },
+	{ "default",  long(64_KiB)                 },
+	{ "persist",  false                        },
+};
+
 //
 // cache::cache
 //
@@ -2960,7 +3042,8 @@ ircd::db::database::cache::DEFAULT_HI_PRIO
 ircd::db::database::cache::cache(database *const &d,
                                  std::shared_ptr<struct database::stats> stats,
                                  std::string name,
-                                 const ssize_t &initial_capacity)
+                                 const ssize_t &initial_capacity,
+                                 const double &hi_prio)
 :d{d}
 ,name{std::move(name)}
 ,stats{std::move(stats)}
@@ -2971,16 +3054,77 @@ ircd::db::database::cache::cache(database *const &d,
 		std::max(initial_capacity, ssize_t(0))
 		,DEFAULT_SHARD_BITS
 		,DEFAULT_STRICT
-		,DEFAULT_HI_PRIO
+		,hi_prio
 	)
 }
 {
 	assert(bool(c));
 }
 
+ircd::db::database::cache::cache(database *const &d,
+                                 std::shared_ptr<struct database::stats> stats,
+                                 std::string name,
+                                 std::shared_ptr<cache> root,
+                                 const size_t &capacity)
+:d{d}
+,name{std::move(name)}
+,stats{std::move(stats)}
+,root{std::move(root)}
+,quota{&this->root->quotas.emplace_back()}
+,c{this->root->c}
+{
+	assert(bool(c));
+	this->quota->name = this->name;
+	this->quota->capacity = capacity;
+	c->SetCapacity(c->GetCapacity() + capacity);
+
+	if(!this->root->sketch)
+		this->root->sketch = std::make_unique<struct sketch>(size_t(sketch_width));
+}
+
 ircd::db::database::cache::~cache()
 noexcept
 {
+	// The quota remains with the root for any of our entries still cached,
+	// but its share of the capacity is returned.
+	if(quota)
+	{
+		c->SetCapacity(c->GetCapacity() - quota->capacity);
+		quota->capacity = 0;
+	}
+}
+
+rocksdb::Cache::Priority
+ircd::db::database::cache::admit(const Slice &key,
+                                 const size_t &charge,
+                                 const Priority &priority)
+const
+{
+	assert(quota);
+	assert(root && root->sketch);
+
+	const size_t usage
+	{
+		quota->usage + charge
+	};
+
+	// Under the hard minimum the column is protected regardless.
+	if(usage <= quota->capacity * double(shared_minimum))
+		return Priority::HIGH;
+
+	// Over the soft quota the column only borrows from the probation pool.
+	if(usage > quota->capacity)
+		return Priority::LOW;
+
+	const uint64_t hash
+	{
+		std::hash<string_view>{}(slice(key))
+	};
+
+	if(root->sketch->estimate(hash) >= size_t(admit_freq))
+		return Priority::HIGH;
+
+	return priority;
 }
 
 const char *
@@ -3004,11 +3148,37 @@ noexcept
 	assert(bool(c));
 	assert(bool(stats));
 
+	// A view wraps the value so the eviction can be credited to its quota.
+	entry *const e
+	{
+		quota?
+			new entry{value, del, quota, charge}:
+			nullptr
+	};
+
+	if(e)
+	{
+		priority = admit(key, charge, priority);
+		quota->usage += charge;
+		quota->count += 1;
+	}
+
 	const rocksdb::Status &ret
 	{
-		c->Insert(key, value, charge, del, handle, priority)
+		e?
+			c->Insert(key, e, charge, entry::destroy, handle, priority):
+			c->Insert(key, value, charge, del, handle, priority)
 	};
 
+	// When the insert fails with a handle the deleter is not called and the
+	// value is still owned by the caller.
+	if(e && !ret.ok() && handle)
+	{
+		quota->usage -= charge;
+		quota->count -= 1;
+		delete e;
+	}
+
 	stats->recordTick(rocksdb::Tickers::BLOCK_CACHE_ADD, ret.ok());
 	stats->recordTick(rocksdb::Tickers::BLOCK_CACHE_ADD_FAILURES, !ret.ok());
 	stats->recordTick(rocksdb::Tickers::BLOCK_CACHE_DATA_BYTES_INSERT, ret.ok()? charge : 0UL);
@@ -3040,6 +3210,12 @@ noexcept
 		c->Lookup(key, s)
 	};
 
+	// Every access to a shared cache is sampled for admission whether or
+	// not it hits; a miss followed by the insert is the first sample. Scans
+	// are not sampled so a one-off pass can't make its keys look popular.
+	if(root && !scan::current())
+		root->sketch->add(std::hash<string_view>{}(slice(key)));
+
 	// Rocksdb's LRUCache stats are broke. The statistics ptr is null and
 	// passing it to Lookup() does nothing internally. We have to do this
 	// here ourselves :/
@@ -3071,7 +3247,14 @@ ircd::db::database::cache::Value(Handle *const handle)
 noexcept
 {
 	assert(bool(c));
-	return c->Value(handle);
+	void *const value
+	{
+		c->Value(handle)
+	};
+
+	return quota?
+		static_cast<entry *>(value)->value:
+		value;
 }
 
 void
@@ -3095,7 +3278,12 @@ ircd::db::database::cache::SetCapacity(size_t capacity)
 noexcept
 {
 	assert(bool(c));
-	return c->SetCapacity(capacity);
+	if(!quota)
+		return c->SetCapacity(capacity);
+
+	// The view's capacity is its quota; the shared capacity follows the sum.
+	c->SetCapacity(c->GetCapacity() - quota->capacity + capacity);
+	quota->capacity = capacity;
 }
 
 void
@@ -3119,7 +3307,9 @@ ircd::db::database::cache::GetCapacity()
 const noexcept
 {
 	assert(bool(c));
-	return c->GetCapacity();
+	return quota?
+		quota->capacity:
+		c->GetCapacity();
 }
 
 size_t
@@ -3127,7 +3317,9 @@ ircd::db::database::cache::GetUsage()
 const noexcept
 {
 	assert(bool(c));
-	return c->GetUsage();
+	return quota?
+		quota->usage.load(std::memory_order_relaxed):
+		c->GetUsage();
 }
 
 size_t
@@ -3160,7 +3352,30 @@ ircd::db::database::cache::ApplyToAllCacheEntries(callback cb,
 noexcept
 {
 	assert(bool(c));
-	return c->ApplyToAllCacheEntries(cb, thread_safe);
+	if(!quota)
+		return c->ApplyToAllCacheEntries(cb, thread_safe);
+
+	// The C-style callback has no user argument; the view and the caller's
+	// callback are passed to ours by these. Only the entries of this view
+	// are presented to the caller, unwrapped.
+	thread_local const struct quota *_quota;
+	thread_local callback _cb;
+	_quota = quota;
+	_cb = cb;
+
+	c->ApplyToAllCacheEntries([]
+	(void *const value, const size_t charge)
+	noexcept
+	{
+		const auto &e
+		{
+			*static_cast<entry *>(value)
+		};
+
+		if(e.quota == _quota)
+			_cb(e.value, charge);
+	},
+	thread_safe);
 }
 
 void
@@ -3168,6 +3383,17 @@ ircd::db::database::cache::EraseUnRefEntries()
 noexcept
 {
 	assert(bool(c));
+
+	// The LRU cannot select the entries of one view; clearing a view
+	// clears the shared cache for every column of the database.
+	if(quota)
+		log::warning
+		{
+			log, "'%s': Clearing cache of '%s' clears the shared cache of all columns.",
+			d->name,
+			name,
+		};
+
 	return c->EraseUnRefEntries();
 }
 
@@ -3189,6 +3415,140 @@ noexcept
 
 }
 
+//
+// cache::entry
+//
+
+void
+ircd::db::database::cache::entry::destroy(const Slice &key,
+                                          void *const value)
+noexcept
+{
+	auto *const e
+	{
+		static_cast<entry *>(value)
+	};
+
+	assert(e);
+	assert(e->quota);
+	assert(e->quota->usage >= e->charge);
+	e->quota->usage -= e->charge;
+	e->quota->count -= 1;
+
+	if(e->del)
+		e->del(key, e->value);
+
+	delete e;
+}
+
+//
+// cache::scan
+//
+
+thread_local
+decltype(ircd::db::database::cache::scan::active)
+ircd::db::database::cache::scan::active;
+
+ircd::db::database::cache::scan::scan(const rocksdb::ReadOptions &opts)
+:marked
+{
+	!opts.fill_cache && ctx::current
+}
+{
+	if(marked)
+		active.emplace_back(ctx::current);
+}
+
+ircd::db::database::cache::scan::~scan()
+noexcept
+{
+	if(!marked)
+		return;
+
+	const auto it
+	{
+		std::find(rbegin(active), rend(active), ctx::current)
+	};
+
+	assert(it != rend(active));
+	active.erase(std::next(it).base());
+}
+
+bool
+ircd::db::database::cache::scan::current()
+{
+	return !active.empty() && ctx::current &&
+		std::find(begin(active), end(active), ctx::current) != end(active);
+}
+
+//
+// cache::sketch
+//
+
+ircd::db::database::cache::sketch::sketch(const size_t &width)
+:mask
+{
+	// rounded up to a power of two
+	(1UL << (64 - __builtin_clzl(std::max(width, 64UL) - 1))) - 1
+}
+,period
+{
+	(mask + 1) * 10
+}
+,counter
+(
+	ROWS * (mask + 1)
+)
+{
+}
+
+void
+ircd::db::database::cache::sketch::add(const uint64_t &hash)
+{
+	for(size_t i(0); i < ROWS; ++i)
+	{
+		auto &ctr(counter.at(index(hash, i)));
+		uint8_t val(ctr.load(std::memory_order_relaxed));
+		while(val < MAX && !ctr.compare_exchange_weak(val, val + 1, std::memory_order_relaxed));
+	}
+
+	// Only the sampler reaching the period ages the sketch; the others
+	// continue counting past it in the meantime.
+	if(samples.fetch_add(1, std::memory_order_relaxed) + 1 == period)
+		age();
+}
+
+void
+ircd::db::database::cache::sketch::age()
+{
+	for(auto &ctr : counter)
+		ctr.store(ctr.load(std::memory_order_relaxed) >> 1, std::memory_order_relaxed);
+
+	samples.fetch_sub(period / 2, std::memory_order_relaxed);
+}
+
+uint8_t
+ircd::db::database::cache::sketch::estimate(const uint64_t &hash)
+const
+{
+	uint8_t ret(MAX);
+	for(size_t i(0); i < ROWS; ++i)
+		ret = std::min(ret, counter.at(index(hash, i)).load(std::memory_order_relaxed));
+
+	return ret;
+}
+
+size_t
+ircd::db::database::cache::sketch::index(const uint64_t &hash,
+                                         const size_t &row)
+const
+{
+	// Each row is indexed by a different combination of the two halves of
+	// the hash (Kirsch-Mitzenmacher) rather than hashing the key again.
+	const uint64_t h1(hash), h2((hash >> 32) | (hash << 32));
+	return row * (mask + 1) + ((h1 + row * h2) & mask);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // database::compaction_filter
@@ -3975,6 +4335,77 @@ ircd::db::txn::operator()(database &d,
 	this->state = state::COMMIT;
 	commit(d, *wb, opts);
 	this->state = state::COMMITTED;
+	d.on_commit(*this);
+}
+
+/// Group commit. The batches are concatenated into a single WriteBatch so
+/// the database conducts one write and one WAL sync for the whole group;
+/// the deltas are applied in the order of the input. If the write fails all
+/// of the transactions are returned to the BUILD state so they may be
+/// committed again individually.
+void
+ircd::db::commit(const vector_view<txn *const> &txns,
+                 const sopts &sopts)
+{
+	if(txns.empty())
+		return;
+
+	if(txns.size() == 1)
+		return (*txns[0])(sopts);
+
+	// WriteBatch rep := sequence:fixed64 count:fixed32 record[count]
+	static constexpr const size_t header_size
+	{
+		sizeof(uint64_t) + sizeof(uint32_t)
+	};
+
+	assert(txns[0] && txns[0]->d);
+	database &d(*txns[0]->d);
+	size_t bytes(header_size), count(0);
+	for(const auto *const t : txns)
+	{
+		assert(t && t->d == &d);
+		assert(bool(t->wb));
+		assert(t->state == txn::state::BUILD);
+		assert(t->wb->GetDataSize() >= header_size);
+		bytes += t->wb->GetDataSize() - header_size;
+		count += t->wb->Count();
+	}
+
+	std::string rep;
+	rep.reserve(bytes);
+	rep.assign(header_size, '\0');
+	for(const auto *const t : txns)
+	{
+		const auto &data(t->wb->Data());
+		rep.append(data.data() + header_size, data.size() - header_size);
+	}
+
+	assert(count <= std::numeric_limits<uint32_t>::max());
+	for(size_t i(0); i < sizeof(uint32_t); ++i)
+		rep[sizeof(uint64_t) + i] = char(count >> (i * 8));
+
+	rocksdb::WriteBatch batch
+	{
+		std::move(rep)
+	};
+
+	assert(size_t(batch.Count()) == count);
+	for(auto *const t : txns)
+		t->state = txn::state::COMMIT;
+
+	const unwind::exceptional rollback{[&txns]
+	{
+		for(auto *const t : txns)
+			t->state = txn::state::BUILD;
+	}};
+
+	commit(d, batch, sopts);
+	for(auto *const t : txns)
+		t->state = txn::state::COMMITTED;
+
+	for(const auto *const t : txns)
+		d.on_commit(*t);
 }
 
 void
@@ -4239,6 +4670,175 @@ ircd::db::txn::append::append(txn &t,
 	});
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// db/prefetcher.h
+//
+
+namespace ircd::db
+{
+	extern ircd::stats::item prefetch_submit;
+	extern ircd::stats::item prefetch_cached;
+	extern ircd::stats::item prefetch_dropped;
+	extern ircd::stats::item prefetch_hit;
+	extern ircd::stats::item prefetch_late;
+	extern ircd::stats::item prefetch_wasted;
+}
+
+struct ircd::db::prefetcher::request
+{
+	std::string key;
+	size_t remain {0};
+	bool dropped {false};
+};
+
+decltype(ircd::db::prefetch_submit)
+ircd::db::prefetch_submit
+{
+	{ "name", "ircd.db.prefetch.submit" },
+};
+
+decltype(ircd::db::prefetch_cached)
+ircd::db::prefetch_cached
+{
+	{ "name", "ircd.db.prefetch.cached" },
+};
+
+decltype(ircd::db::prefetch_dropped)
+ircd::db::prefetch_dropped
+{
+	{ "name", "ircd.db.prefetch.dropped" },
+};
+
+decltype(ircd::db::prefetch_hit)
+ircd::db::prefetch_hit
+{
+	{ "name", "ircd.db.prefetch.hit" },
+};
+
+decltype(ircd::db::prefetch_late)
+ircd::db::prefetch_late
+{
+	{ "name", "ircd.db.prefetch.late" },
+};
+
+decltype(ircd::db::prefetch_wasted)
+ircd::db::prefetch_wasted
+{
+	{ "name", "ircd.db.prefetch.wasted" },
+};
+
+ircd::db::prefetcher::prefetcher(const size_t &window)
+:window{window}
+{
+}
+
+ircd::db::prefetcher &
+ircd::db::prefetcher::operator=(prefetcher &&other)
+{
+	clear();
+	window = other.window;
+	queue = std::move(other.queue);
+	return *this;
+}
+
+ircd::db::prefetcher::~prefetcher()
+noexcept
+{
+	clear();
+}
+
+void
+ircd::db::prefetcher::clear()
+{
+	prefetch_wasted += queue.size();
+	queue.clear();
+}
+
+bool
+ircd::db::prefetcher::consume(const string_view &key)
+{
+	while(!queue.empty())
+	{
+		const auto request
+		{
+			std::move(queue.front())
+		};
+
+		queue.pop_front();
+		if(request->key != key)
+		{
+			prefetch_wasted += 1;
+			continue;
+		}
+
+		const bool hit
+		{
+			!request->remain && !request->dropped
+		};
+
+		prefetch_hit += hit;
+		prefetch_late += !hit;
+		return hit;
+	}
+
+	return false;
+}
+
+bool
+ircd::db::prefetcher::operator()(column &column,
+                                 const string_view &key,
+                                 const gopts &gopts)
+{
+	const bool join
+	{
+		!queue.empty() && queue.back()->key == key
+	};
+
+	if(!join && full())
+		return false;
+
+	if(!join)
+		queue.emplace_back(std::make_shared<request>(request
+		{
+			std::string(key)
+		}));
+
+	const auto &request
+	{
+		queue.back()
+	};
+
+	if(cached(column, key, gopts))
+	{
+		prefetch_cached += 1;
+		return true;
+	}
+
+	if(!db::request.avail())
+	{
+		request->dropped = true;
+		prefetch_dropped += 1;
+		return true;
+	}
+
+	++request->remain;
+	prefetch_submit += 1;
+	db::request([column(column), request, gopts]
+	() mutable
+	{
+		const unwind done{[&request]
+		{
+			assert(request->remain > 0);
+			--request->remain;
+		}};
+
+		has(column, request->key, gopts);
+	});
+
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // db/row.h
@@ -5216,6 +5816,83 @@ ircd::db::read(column &column,
 	return ret;
 }
 
+std::vector<std::string>
+ircd::db::read(column &column,
+               const vector_view<const string_view> &keys,
+               std::vector<bool> &found,
+               const gopts &gopts)
+{
+	std::vector<std::pair<db::column *, string_view>> ops(keys.size());
+	std::transform(std::begin(keys), std::end(keys), std::begin(ops), [&column]
+	(const string_view &key)
+	{
+		return std::make_pair(&column, key);
+	});
+
+	return read(ops, found, gopts);
+}
+
+/// MultiGet allows RocksDB to share the memtable and block cache lookups
+/// among the keys and submit all of the resulting reads to the environment
+/// at once; for N keys this is considerably cheaper than N iterator seeks.
+/// All columns must belong to the same database.
+std::vector<std::string>
+ircd::db::read(const vector_view<const std::pair<column *, string_view>> &ops,
+               std::vector<bool> &found,
+               const gopts &gopts)
+{
+	std::vector<std::string> ret;
+	found.assign(ops.size(), false);
+	if(ops.empty())
+		return ret;
+
+	assert(ops[0].first);
+	database &d(*ops[0].first);
+	std::vector<rocksdb::ColumnFamilyHandle *> handles(ops.size());
+	std::vector<rocksdb::Slice> keys(ops.size());
+	for(size_t i(0); i < ops.size(); ++i)
+	{
+		assert(ops[i].first);
+		database::column &c(*ops[i].first);
+		assert(c.d == &d);
+		handles[i] = c;
+		keys[i] = slice(ops[i].second);
+	}
+
+	const rocksdb::ReadOptions opts
+	{
+		make_opts(gopts)
+	};
+
+	const ctx::uninterruptible::nothrow ui;
+	const database::cache::scan scan{opts};
+	const std::vector<rocksdb::Status> status
+	{
+		d.d->MultiGet(opts, handles, keys, &ret)
+	};
+
+	assert(status.size() == ops.size());
+	assert(ret.size() == ops.size());
+	for(size_t i(0); i < status.size(); ++i)
+		switch(status[i].code())
+		{
+			case rocksdb::Status::kOk:
+				found[i] = true;
+				continue;
+
+			case rocksdb::Status::kNotFound:
+				continue;
+
+			default:
+				throw_on_error
+				{
+					status[i]
+				};
+		}
+
+	return ret;
+}
+
 rocksdb::Cache *
 ircd::db::cache(column &column)
 {
@@ -5713,11 +6390,18 @@ ircd::db::prefetch(column &column,
                    const gopts &gopts)
 {
 	if(cached(column, key, gopts))
+	{
+		prefetch_cached += 1;
 		return;
+	}
 
 	if(!request.avail())
+	{
+		prefetch_dropped += 1;
 		return;
+	}
 
+	prefetch_submit += 1;
 	request([column(column), key(std::string(key)), gopts]
 	() mutable
 	{
@@ -6600,7 +7284,7 @@ ircd::db::ticker(const rocksdb::Cache *const &cache,
 	return cache? ticker(*cache, ticker_id) : 0UL;
 }
 
-const uint64_t &
+uint64_t
 ircd::db::ticker(const rocksdb::Cache &cache,
                  const uint32_t &ticker_id)
 {
@@ -6609,14 +7293,9 @@ ircd::db::ticker(const rocksdb::Cache &cache,
 		dynamic_cast<const database::cache &>(cache)
 	};
 
-	static const uint64_t &zero
-	{
-		0ULL
-	};
-
 	return c.stats?
-		c.stats->ticker.at(ticker_id):
-		zero;
+		c.stats->getTickerCount(ticker_id):
+		0UL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -7150,6 +7829,7 @@ ircd::db::_seek(database::column &c,
                 rocksdb::Iterator &it)
 {
 	const ctx::uninterruptible ui;
+	const database::cache::scan scan{opts};
 
 	#ifdef RB_DEBUG_DB_SEEK
 	database &d(*c.d);
@@ -7180,6 +7860,8 @@ ircd::db::_seek(database::column &c,
                 const rocksdb::ReadOptions &opts,
                 rocksdb::Iterator &it)
 {
+	const database::cache::scan scan{opts};
+
 	#ifdef RB_DEBUG_DB_SEEK
 	database &d(*c.d);
 	const ircd::timer timer;
@@ -7495,6 +8177,7 @@ ircd::db::operator+=(rocksdb::ReadOptions &ret,
 	ret.pin_data = test(opts, get::PIN);
 	ret.fill_cache |= test(opts, get::CACHE);
 	ret.fill_cache &= !test(opts, get::NO_CACHE);
+	ret.fill_cache &= !test(opts, get::SCAN);
 	ret.tailing = test(opts, get::NO_SNAPSHOT);
 	ret.prefix_same_as_start = test(opts, get::PREFIX);
 	ret.total_order_seek = test(opts, get::ORDERED);
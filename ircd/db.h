@@ -142,6 +142,19 @@ namespace ircd::db
 	void append(rocksdb::WriteBatch &, const cell::delta &delta);
 }
 
+/// Internal support for the env port (see env/port.h).
+namespace ircd::db::port
+{
+	// Number of kernel threads which may call into RocksDB; zero when all
+	// background work runs on contexts.
+	extern std::atomic<size_t> threads;
+
+	void wait(std::atomic<uint32_t> &, const uint32_t &val, const microseconds &timeout = 0us) noexcept;
+	void wake(std::atomic<uint32_t> &, const int &count = 1) noexcept;
+	void yield(const size_t &attempt);
+	void spin(const size_t &attempt) noexcept;
+}
+
 struct ircd::db::throw_on_error
 {
 	throw_on_error(const rocksdb::Status & = rocksdb::Status::OK());
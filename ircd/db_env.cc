@@ -771,6 +771,9 @@ noexcept try
 	};
 	#endif
 
+	if(unlikely(!ctx::current))
+		return std::this_thread::sleep_for(microseconds(micros));
+
 	ctx::sleep(microseconds(micros));
 }
 catch(const std::exception &e)
@@ -813,6 +816,27 @@ noexcept try
 		*st->pool.at(prio)
 	};
 
+	// A job executing on one of the pool's kernel threads schedules its
+	// follow-up work from that thread. The pool is only ever modified on the
+	// main thread, so the task is posted there; pool::wait() accounts for it
+	// until it has been queued.
+	if(unlikely(!ctx::current && !is_main_thread()))
+	{
+		++pool.marshalled;
+		ircd::post(state::pool::marshal, [&pool, task(state::task{f, u, a})]() mutable
+		{
+			const unwind done{[&pool]
+			{
+				--pool.marshalled;
+				pool.dock.notify_all();
+			}};
+
+			pool(std::move(task));
+		});
+
+		return;
+	}
+
 	pool(state::task
 	{
 		f, u, a
@@ -855,6 +879,30 @@ noexcept try
 		*st->pool.at(prio)
 	};
 
+	// RocksDB accounts for the number of cancelled jobs, so a call from a
+	// kernel thread blocks that thread until the main thread has performed
+	// the cancellation and produced the count.
+	if(unlikely(!ctx::current && !is_main_thread()))
+	{
+		int ret {0};
+		std::atomic<uint32_t> done {0};
+		ircd::post(state::pool::marshal, [&pool, &tag, &ret, &done]
+		{
+			const unwind release{[&done]
+			{
+				done.store(1, std::memory_order_release);
+				db::port::wake(done);
+			}};
+
+			ret = pool.cancel(tag);
+		});
+
+		while(!done.load(std::memory_order_acquire))
+			db::port::wait(done, 0);
+
+		return ret;
+	}
+
 	return pool.cancel(tag);
 }
 catch(const std::exception &e)
@@ -1160,6 +1208,11 @@ const noexcept try
 	};
 	#endif
 
+	// Kernel threads of the pools are identified by their system thread id
+	// since they have no context.
+	if(unlikely(!ctx::current))
+		return std::hash<std::thread::id>{}(std::this_thread::get_id());
+
 	return ctx::this_ctx::id();
 }
 catch(const std::exception &e)
@@ -3950,6 +4003,24 @@ ircd::db::database::env::state::pool::stack_size
 	{ "default",  long(128_KiB)                 },
 };
 
+/// The maximum number of kernel threads each pool (i.e LOW and HIGH) may
+/// execute RocksDB background jobs on. When zero the jobs run on the pool's
+/// contexts on the main thread. Changes take effect when a database is opened.
+decltype(ircd::db::database::env::state::pool::threads)
+ircd::db::database::env::state::pool::threads
+{
+	{ "name",     "ircd.db.env.pool.threads" },
+	{ "default",  0L                         },
+};
+
+/// Scheduling requests made by background jobs running on a kernel thread
+/// are posted to the main thread under this descriptor.
+decltype(ircd::db::database::env::state::pool::marshal)
+ircd::db::database::env::state::pool::marshal
+{
+	"ircd.db.env.pool.marshal"
+};
+
 //
 // state::pool::pool
 //
@@ -3976,6 +4047,12 @@ ircd::db::database::env::state::pool::pool(database &d,
 	reflect(pri),  // name of pool
 	this->popts    // pool options
 }
+,workers
+{
+	size_t(threads)?
+		std::make_unique<struct workers>(*this, size_t(threads)):
+		nullptr
+}
 {
 }
 
@@ -4004,6 +4081,7 @@ try
 	assert(!p.pending());
 	assert(tasks.empty());
 	p.join();
+	workers.reset(nullptr);
 
 	log::debug
 	{
@@ -4030,7 +4108,7 @@ ircd::db::database::env::state::pool::wait()
 {
 	dock.wait([this]
 	{
-		return tasks.empty() && !p.pending();
+		return tasks.empty() && !p.pending() && !marshalled;
 	});
 }
 
@@ -4074,8 +4152,12 @@ ircd::db::database::env::state::pool::operator()(task &&task)
 			task.func
 		};
 
-		// Execute the task
-		task.func(task.arg);
+		// Execute the task; or have a kernel thread execute it while this
+		// context waits.
+		if(workers)
+			(*workers)(task);
+		else
+			task.func(task.arg);
 
 		log::debug
 		{
@@ -4122,3 +4204,112 @@ ircd::db::database::env::state::pool::cancel(void *const &tag)
 	dock.notify_all();
 	return i;
 }
+
+//
+// state::pool::workers
+//
+
+decltype(ircd::db::database::env::state::pool::workers::completion)
+ircd::db::database::env::state::pool::workers::completion
+{
+	"ircd.db.env.pool.workers.completion"
+};
+
+ircd::db::database::env::state::pool::workers::workers(pool &p,
+                                                       const size_t &max)
+:p{p}
+,max{max}
+{
+	assert(max > 0);
+}
+
+ircd::db::database::env::state::pool::workers::~workers()
+noexcept
+{
+	std::unique_lock lock(mutex);
+	assert(queue.empty());
+	terminate = true;
+	cond.notify_all();
+	lock.unlock();
+
+	for(auto &thread : threads)
+		thread.join();
+
+	db::port::threads -= threads.size();
+	log::debug
+	{
+		log, "'%s': Joined %zu threads of pool '%s'.",
+		p.d.name,
+		threads.size(),
+		ctx::name(p.p),
+	};
+}
+
+/// Called on the pool's context with the task it has dequeued. The context
+/// yields until the task has been executed by one of the threads. A thread
+/// is spawned here if none are idle and the maximum has not been reached.
+void
+ircd::db::database::env::state::pool::workers::operator()(const task &task)
+{
+	bool done {false};
+	std::unique_lock lock(mutex);
+	queue.emplace_back(work{&task, &done});
+	if(idle < queue.size() && threads.size() < max)
+	{
+		threads.emplace_back(&workers::worker, this);
+		++db::port::threads;
+		log::debug
+		{
+			log, "'%s': pool:%s spawned thread %zu of %zu",
+			p.d.name,
+			ctx::name(p.p),
+			threads.size(),
+			max,
+		};
+	}
+
+	cond.notify_one();
+	lock.unlock();
+
+	// The context must remain here until the thread posts the completion;
+	// the caller has made this scope uninterruptible.
+	p.dock.wait([&done]
+	{
+		return done;
+	});
+}
+
+void
+ircd::db::database::env::state::pool::workers::worker()
+noexcept
+{
+	std::unique_lock lock(mutex);
+	while(1)
+	{
+		++idle;
+		cond.wait(lock, [this]
+		{
+			return !queue.empty() || terminate;
+		});
+
+		--idle;
+		if(queue.empty())
+			return;
+
+		const auto work(queue.front());
+		queue.pop_front();
+		lock.unlock();
+
+		assert(work.task);
+		work.task->func(work.task->arg);
+
+		// The waiting context is notified through the dock on the main thread.
+		ircd::post(completion, [this, done(work.done)]
+		{
+			*done = true;
+			p.dock.notify_all();
+		});
+
+		lock.lock();
+	}
+}
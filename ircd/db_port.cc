@@ -8,8 +8,83 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "db.h"
 
+//
+// port (internal)
+//
+
+decltype(ircd::db::port::threads)
+ircd::db::port::threads;
+
+/// Block the calling kernel thread while `word` == `val`. This is never
+/// called on the main thread. A timeout of zero waits indefinitely. Returns
+/// on wakeup, timeout or spuriously; the caller always re-checks its condition.
+void
+ircd::db::port::wait(std::atomic<uint32_t> &word,
+                     const uint32_t &val,
+                     const microseconds &timeout)
+noexcept
+{
+	assert(!ctx::current);
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+	const auto s
+	{
+		duration_cast<seconds>(timeout)
+	};
+
+	const struct ::timespec ts
+	{
+		s.count(), duration_cast<nanoseconds>(timeout - s).count()
+	};
+
+	::syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, val, timeout > 0us? &ts : nullptr, nullptr, 0);
+}
+
+/// Wake up to `count` kernel threads blocked in wait() on `word`. Safe to call
+/// from any thread. Contexts waiting on the same structure are not woken by
+/// this; they poll (see yield()).
+void
+ircd::db::port::wake(std::atomic<uint32_t> &word,
+                     const int &count)
+noexcept
+{
+	::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+/// A context contending with a kernel thread cannot block the event loop, so
+/// it yields to other contexts and then backs off with short sleeps until the
+/// thread releases the structure. Contention of this kind only exists when
+/// the env runs background jobs on kernel threads.
+void
+ircd::db::port::yield(const size_t &attempt)
+{
+	assert(ctx::current);
+	if(attempt < 8)
+		return ctx::yield();
+
+	ctx::sleep(microseconds(std::min(attempt, 1000UL)));
+}
+
+/// The main stack outside of any context can neither yield to contexts nor
+/// sleep indefinitely on a futex, so while it contends with a kernel thread
+/// it spins and then backs off with short sleeps until the thread releases
+/// the structure. This is only reached while the env has threads.
+void
+ircd::db::port::spin(const size_t &attempt)
+noexcept
+{
+	assert(!ctx::current);
+	assert(is_main_thread());
+	if(attempt < 64)
+		return std::this_thread::yield();
+
+	std::this_thread::sleep_for(microseconds(std::min(attempt, 1000UL)));
+}
+
 //
 // Mutex
 //
@@ -58,13 +133,47 @@ noexcept
 	#endif
 }
 
+// The word `xm` is 0 when unlocked, 1 when locked, and 2 when locked with
+// kernel threads possibly sleeping on it. Calls from the main thread outside
+// of any context remain no-ops while the env has no threads, as they have
+// always been; otherwise they must exclude the threads as well.
 void
 __attribute__((externally_visible, noinline))
 rocksdb::port::Mutex::Lock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(is_main_thread())
+		{
+			if(likely(!ircd::db::port::threads))
+				return;
+
+			for(size_t i(0);; ++i)
+			{
+				uint32_t expect {0};
+				if(likely(xm.compare_exchange_weak(expect, 1, std::memory_order_acquire)))
+					return;
+
+				ircd::db::port::spin(i);
+			}
+		}
+
+		uint32_t expect {0};
+		if(likely(xm.compare_exchange_strong(expect, 1, std::memory_order_acquire)))
+			return;
+
+		if(expect != 2)
+			expect = xm.exchange(2, std::memory_order_acquire);
+
+		while(expect != 0)
+		{
+			ircd::db::port::wait(xm, 2);
+			expect = xm.exchange(2, std::memory_order_acquire);
+		}
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -76,6 +185,18 @@ noexcept
 	assert_main_thread();
 	const ctx::uninterruptible::nothrow ui;
 	mu.lock();
+
+	// Contexts are now serialized on `mu`; the holder still has to exclude
+	// any kernel thread. This always succeeds on the first attempt when the
+	// env has no threads.
+	for(size_t i(0);; ++i)
+	{
+		uint32_t expect {0};
+		if(likely(xm.compare_exchange_weak(expect, 1, std::memory_order_acquire)))
+			break;
+
+		ircd::db::port::yield(i);
+	}
 }
 
 void
@@ -84,7 +205,16 @@ rocksdb::port::Mutex::Unlock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(is_main_thread() && likely(!ircd::db::port::threads))
+			return;
+
+		assert(xm.load(std::memory_order_relaxed) != 0);
+		if(xm.exchange(0, std::memory_order_release) == 2)
+			ircd::db::port::wake(xm, 1);
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -95,6 +225,10 @@ noexcept
 
 	assert_main_thread();
 	assert(mu.locked());
+	assert(xm.load(std::memory_order_relaxed) != 0);
+	if(unlikely(xm.exchange(0, std::memory_order_release) == 2))
+		ircd::db::port::wake(xm, 1);
+
 	const ctx::uninterruptible::nothrow ui;
 	mu.unlock();
 }
@@ -105,9 +239,13 @@ rocksdb::port::Mutex::AssertHeld()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		assert((is_main_thread() && !ircd::db::port::threads) || xm.load(std::memory_order_relaxed) != 0);
 		return;
+	}
 
 	assert(mu.locked());
+	assert(xm.load(std::memory_order_relaxed) != 0);
 }
 
 //
@@ -151,13 +289,45 @@ noexcept
 	#endif
 }
 
+// The word `xs` counts the readers holding the lock, or is `writer` when it
+// is held exclusively. Contexts first queue on the ctx::shared_mutex so only
+// contention with kernel threads is resolved on the word itself.
+namespace rocksdb::port
+{
+	static constexpr const uint32_t writer
+	{
+		std::numeric_limits<uint32_t>::max()
+	};
+
+	static bool try_lock_shared(std::atomic<uint32_t> &xs) noexcept;
+	static bool try_lock(std::atomic<uint32_t> &xs) noexcept;
+	static void unlock_shared(std::atomic<uint32_t> &xs) noexcept;
+	static void unlock(std::atomic<uint32_t> &xs) noexcept;
+}
+
 void
 __attribute__((externally_visible, noinline))
 rocksdb::port::RWMutex::ReadLock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(is_main_thread())
+		{
+			if(likely(!ircd::db::port::threads))
+				return;
+
+			for(size_t i(0); !try_lock_shared(xs); ++i)
+				ircd::db::port::spin(i);
+
+			return;
+		}
+
+		while(!try_lock_shared(xs))
+			ircd::db::port::wait(xs, writer);
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -169,6 +339,8 @@ noexcept
 	assert_main_thread();
 	const ctx::uninterruptible::nothrow ui;
 	mu.lock_shared();
+	for(size_t i(0); !try_lock_shared(xs); ++i)
+		ircd::db::port::yield(i);
 }
 
 void
@@ -177,7 +349,24 @@ rocksdb::port::RWMutex::WriteLock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(is_main_thread())
+		{
+			if(likely(!ircd::db::port::threads))
+				return;
+
+			for(size_t i(0); !try_lock(xs); ++i)
+				ircd::db::port::spin(i);
+
+			return;
+		}
+
+		for(uint32_t x(xs.load(std::memory_order_relaxed)); !try_lock(xs); x = xs.load(std::memory_order_relaxed))
+			if(x != 0)
+				ircd::db::port::wait(xs, x);
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -189,6 +378,8 @@ noexcept
 	assert_main_thread();
 	const ctx::uninterruptible::nothrow ui;
 	mu.lock();
+	for(size_t i(0); !try_lock(xs); ++i)
+		ircd::db::port::yield(i);
 }
 
 void
@@ -197,7 +388,12 @@ rocksdb::port::RWMutex::ReadUnlock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(!is_main_thread() || unlikely(ircd::db::port::threads))
+			unlock_shared(xs);
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -207,6 +403,7 @@ noexcept
 	#endif
 
 	assert_main_thread();
+	unlock_shared(xs);
 	const ctx::uninterruptible::nothrow ui;
 	mu.unlock_shared();
 }
@@ -217,7 +414,12 @@ rocksdb::port::RWMutex::WriteUnlock()
 noexcept
 {
 	if(unlikely(!ctx::current))
+	{
+		if(!is_main_thread() || unlikely(ircd::db::port::threads))
+			unlock(xs);
+
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -227,10 +429,51 @@ noexcept
 	#endif
 
 	assert_main_thread();
+	unlock(xs);
 	const ctx::uninterruptible::nothrow ui;
 	mu.unlock();
 }
 
+bool
+rocksdb::port::try_lock_shared(std::atomic<uint32_t> &xs)
+noexcept
+{
+	uint32_t x(xs.load(std::memory_order_relaxed));
+	while(x != writer)
+		if(xs.compare_exchange_weak(x, x + 1, std::memory_order_acquire))
+			return true;
+
+	return false;
+}
+
+bool
+rocksdb::port::try_lock(std::atomic<uint32_t> &xs)
+noexcept
+{
+	uint32_t expect {0};
+	return xs.compare_exchange_strong(expect, writer, std::memory_order_acquire);
+}
+
+void
+rocksdb::port::unlock_shared(std::atomic<uint32_t> &xs)
+noexcept
+{
+	assert(xs.load(std::memory_order_relaxed) != 0);
+	assert(xs.load(std::memory_order_relaxed) != writer);
+	if(xs.fetch_sub(1, std::memory_order_release) == 1 && ircd::db::port::threads)
+		ircd::db::port::wake(xs, std::numeric_limits<int>::max());
+}
+
+void
+rocksdb::port::unlock(std::atomic<uint32_t> &xs)
+noexcept
+{
+	assert(xs.load(std::memory_order_relaxed) == writer);
+	xs.store(0, std::memory_order_release);
+	if(ircd::db::port::threads)
+		ircd::db::port::wake(xs, std::numeric_limits<int>::max());
+}
+
 //
 // CondVar
 //
@@ -273,13 +516,33 @@ noexcept
 	#endif
 }
 
+// Every signal advances `seq`. A waiter samples `seq` before releasing the
+// mutex and returns once it has changed; spurious returns are permitted by
+// the interface. Kernel threads sleep on `seq` itself. Contexts sleep on the
+// dock, which a signal from a kernel thread cannot safely notify; while the
+// env has threads the contexts therefore re-check `seq` periodically.
 void
 __attribute__((externally_visible, noinline))
 rocksdb::port::CondVar::Wait()
 noexcept
 {
+	assert(mu);
 	if(unlikely(!ctx::current))
+	{
+		if(is_main_thread())
+			return;
+
+		mu->AssertHeld();
+		const auto gen(seq.load(std::memory_order_acquire));
+		mu->Unlock();
+		++waiters;
+		while(seq.load(std::memory_order_acquire) == gen)
+			ircd::db::port::wait(seq, gen);
+
+		--waiters;
+		mu->Lock();
 		return;
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -288,11 +551,25 @@ noexcept
 	};
 	#endif
 
-	assert(mu);
 	assert_main_thread();
 	mu->AssertHeld();
 	const ctx::uninterruptible::nothrow ui;
-	cv.wait(mu->mu);
+	const auto gen(seq.load(std::memory_order_acquire));
+	const auto signaled{[this, &gen]
+	{
+		return seq.load(std::memory_order_acquire) != gen;
+	}};
+
+	mu->Unlock();
+	while(!signaled())
+	{
+		if(likely(!ircd::db::port::threads))
+			cv.wait(signaled);
+		else
+			cv.wait_for(milliseconds(1), signaled);
+	}
+
+	mu->Lock();
 }
 
 // Returns true if timeout occurred
@@ -301,7 +578,28 @@ __attribute__((externally_visible, noinline))
 rocksdb::port::CondVar::TimedWait(uint64_t abs_time_us)
 noexcept
 {
-	assert(ctx::current);
+	assert(mu);
+	const std::chrono::microseconds us(abs_time_us);
+	const std::chrono::steady_clock::time_point tp(us);
+	const auto gen(seq.load(std::memory_order_acquire));
+	const auto signaled{[this, &gen]
+	{
+		return seq.load(std::memory_order_acquire) != gen;
+	}};
+
+	if(unlikely(!ctx::current))
+	{
+		assert(!is_main_thread());
+		mu->AssertHeld();
+		mu->Unlock();
+		++waiters;
+		for(auto now(steady_clock::now()); !signaled() && now < tp; now = steady_clock::now())
+			ircd::db::port::wait(seq, gen, std::max(duration_cast<microseconds>(tp - now), 1us));
+
+		--waiters;
+		mu->Lock();
+		return !signaled();
+	}
 
 	#ifdef RB_DEBUG_DB_PORT
 	log::debug
@@ -310,13 +608,20 @@ noexcept
 	};
 	#endif
 
-	assert(mu);
 	assert_main_thread();
 	mu->AssertHeld();
-	const std::chrono::microseconds us(abs_time_us);
-	const std::chrono::steady_clock::time_point tp(us);
 	const ctx::uninterruptible::nothrow ui;
-	return cv.wait_until(mu->mu, tp) == std::cv_status::timeout;
+	mu->Unlock();
+	for(auto now(steady_clock::now()); !signaled() && now < tp; now = steady_clock::now())
+	{
+		if(likely(!ircd::db::port::threads))
+			cv.wait_until(tp, signaled);
+		else
+			cv.wait_until(std::min(tp, now + milliseconds(1)), signaled);
+	}
+
+	mu->Lock();
+	return !signaled();
 }
 
 void
@@ -324,6 +629,10 @@ __attribute__((externally_visible, noinline))
 rocksdb::port::CondVar::Signal()
 noexcept
 {
+	seq.fetch_add(1, std::memory_order_release);
+	if(waiters.load(std::memory_order_acquire))
+		ircd::db::port::wake(seq, 1);
+
 	if(unlikely(!ctx::current))
 		return;
 
@@ -335,7 +644,6 @@ noexcept
 	#endif
 
 	assert_main_thread();
-	const ctx::uninterruptible::nothrow ui;
 	cv.notify_one();
 }
 
@@ -344,6 +652,10 @@ __attribute__((externally_visible, noinline))
 rocksdb::port::CondVar::SignalAll()
 noexcept
 {
+	seq.fetch_add(1, std::memory_order_release);
+	if(waiters.load(std::memory_order_acquire))
+		ircd::db::port::wake(seq, std::numeric_limits<int>::max());
+
 	if(unlikely(!ctx::current))
 		return;
 
@@ -355,6 +667,5 @@ noexcept
 	#endif
 
 	assert_main_thread();
-	const ctx::uninterruptible::nothrow ui;
 	cv.notify_all();
 }
@@ -19,6 +19,10 @@
 	#include "fs_aio.h"
 #endif
 
+#ifdef IRCD_USE_IOU
+	#include "fs_iou.h"
+#endif
+
 namespace ircd::fs
 {
 	static uint posix_flags(const std::ios::openmode &mode);
@@ -103,7 +107,8 @@ ircd::fs::support_append
 //
 
 ircd::fs::init::init()
-:_aio_{}
+:_iou_{}
+,_aio_{}
 {
 	debug_paths();
 }
@@ -453,8 +458,20 @@ ircd::fs::flush(const fd &fd,
 		opts.metadata? aio::support_fdsync : aio::support_fsync
 	};
 
+	// AIO completions are delivered to a waiting ircd::ctx; a foreign thread
+	// (i.e. the database env) makes the blocking syscall instead.
+	#ifdef IRCD_USE_IOU
+	if(iou::system && opts.aio && ctx::current)
+	{
+		if(!opts.metadata)
+			return iou::fdsync(fd, opts);
+
+		return iou::fsync(fd, opts);
+	}
+	#endif
+
 	#ifdef IRCD_USE_AIO
-	if(aio::system && opts.aio)
+	if(aio::system && opts.aio && ctx::current)
 	{
 		if(!opts.metadata && aio::support_fdsync)
 			return aio::fdsync(fd, opts);
@@ -691,8 +708,13 @@ ircd::fs::read(const fd &fd,
 {
 	assert(opts.op == op::READ);
 
+	#ifdef IRCD_USE_IOU
+	if(iou::system && opts.aio && ctx::current)
+		return iou::read(fd, iov, opts);
+	#endif
+
 	#ifdef IRCD_USE_AIO
-	if(aio::system && opts.aio)
+	if(aio::system && opts.aio && ctx::current)
 		return aio::read(fd, iov, opts);
 	#endif
 
@@ -1101,8 +1123,13 @@ ircd::fs::write(const fd &fd,
 {
 	assert(opts.op == op::WRITE);
 
+	#ifdef IRCD_USE_IOU
+	if(likely(iou::system) && opts.aio && ctx::current)
+		return iou::write(fd, iov, opts);
+	#endif
+
 	#ifdef IRCD_USE_AIO
-	if(likely(aio::system) && opts.aio)
+	if(likely(aio::system) && opts.aio && ctx::current)
 		return aio::write(fd, iov, opts);
 	#endif
 
@@ -1423,6 +1450,73 @@ noexcept
 }
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// fs/iou.h
+//
+
+//
+// These symbols can be overriden by ircd/fs_iou.cc if it is compiled and
+// linked; otherwise on non-supporting platforms these will be the defaults.
+//
+
+decltype(ircd::fs::iou::support)
+extern __attribute__((weak))
+ircd::fs::iou::support;
+
+/// Conf item to control whether io_uring is enabled or bypassed. When this
+/// is disabled or the kernel refuses io_uring_setup(2) the fs::aio system
+/// (if any) is used instead.
+decltype(ircd::fs::iou::enable)
+ircd::fs::iou::enable
+{
+	{ "name",     "ircd.fs.iou.enable"  },
+	{ "default",  true                  },
+	{ "persist",  false                 },
+};
+
+decltype(ircd::fs::iou::max_events)
+ircd::fs::iou::max_events
+{
+	{ "name",     "ircd.fs.iou.max_events"  },
+	{ "default",  256L                      },
+	{ "persist",  false                     },
+};
+
+decltype(ircd::fs::iou::max_submit)
+ircd::fs::iou::max_submit
+{
+	{ "name",     "ircd.fs.iou.max_submit"  },
+	{ "default",  0L                        },
+	{ "persist",  false                     },
+};
+
+/// Global stats structure
+decltype(ircd::fs::iou::stats)
+ircd::fs::iou::stats;
+
+/// Non-null when io_uring is available for use
+decltype(ircd::fs::iou::system)
+ircd::fs::iou::system;
+
+//
+// init
+//
+
+#ifndef IRCD_USE_IOU
+ircd::fs::iou::init::init()
+{
+}
+#endif
+
+#ifndef IRCD_USE_IOU
+ircd::fs::iou::init::~init()
+noexcept
+{
+	assert(!system);
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // fs/fd.h
@@ -68,6 +68,10 @@ ircd::fs::aio::init::init()
 	if(!bool(aio::enable))
 		return;
 
+	// The io_uring system supersedes this one when it was established.
+	if(iou::system)
+		return;
+
 	system = new struct aio::system
 	(
 		size_t(max_events),
@@ -0,0 +1,1067 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <RB_INC_SYS_MMAN_H
+#include <ircd/asio.h>
+#include "fs_iou.h"
+
+namespace ircd::fs::iou
+{
+	static custom_ptr<uint8_t> map(const int &fd, const size_t &size, const off_t &off);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ircd/fs/iou.h
+//
+// The contents of this section override weak symbols in ircd/fs.cc when this
+// unit is conditionally compiled and linked on io_uring-supporting platforms.
+
+decltype(ircd::fs::iou::support)
+ircd::fs::iou::support
+{
+	info::kversion[0] > 5 ||
+	(info::kversion[0] == 5 && info::kversion[1] >= 1)
+};
+
+//
+// init
+//
+
+/// Establish the io_uring system when enabled. Failure here is not fatal; a
+/// kernel built without io_uring (or a seccomp policy denying it) leaves the
+/// system null so fs::aio is established instead.
+ircd::fs::iou::init::init()
+try
+{
+	assert(!system);
+	if(!bool(iou::enable) || !iou::support)
+		return;
+
+	system = new struct iou::system
+	(
+		size_t(max_events),
+		size_t(max_submit)
+	);
+}
+catch(const std::exception &e)
+{
+	log::warning
+	{
+		log, "io_uring is not available; falling back to AIO :%s",
+		e.what()
+	};
+}
+
+ircd::fs::iou::init::~init()
+noexcept
+{
+	delete system;
+	system = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// fs_iou.h
+//
+
+//
+// request::fsync
+//
+
+ircd::fs::iou::request::fsync::fsync(const int &fd,
+                                     const sync_opts &opts)
+:request{fd, &opts}
+{
+	assert(opts.op == op::SYNC);
+	opcode = IORING_OP_FSYNC;
+}
+
+void
+ircd::fs::iou::fsync(const fd &fd,
+                     const sync_opts &opts)
+{
+	iou::request::fsync request
+	{
+		fd, opts
+	};
+
+	request();
+}
+
+//
+// request::fdsync
+//
+
+ircd::fs::iou::request::fdsync::fdsync(const int &fd,
+                                       const sync_opts &opts)
+:request{fd, &opts}
+{
+	assert(opts.op == op::SYNC);
+	opcode = IORING_OP_FSYNC;
+	flags |= IORING_FSYNC_DATASYNC;
+}
+
+void
+ircd::fs::iou::fdsync(const fd &fd,
+                      const sync_opts &opts)
+{
+	iou::request::fdsync request
+	{
+		fd, opts
+	};
+
+	request();
+}
+
+//
+// request::read
+//
+
+/// Unlike AIO, buffered reads (no O_DIRECT) are conducted asynchronously by
+/// the kernel; a read which misses the page cache is punted to a kernel
+/// worker rather than blocking the submitter.
+ircd::fs::iou::request::read::read(const int &fd,
+                                   const const_iovec_view &iov,
+                                   const read_opts &opts)
+:request{fd, &opts}
+{
+	assert(opts.op == op::READ);
+	opcode = IORING_OP_READV;
+	this->iov = iov;
+	offset = opts.offset;
+}
+
+size_t
+ircd::fs::iou::read(const fd &fd,
+                    const const_iovec_view &bufs,
+                    const read_opts &opts)
+{
+	iou::request::read request
+	{
+		fd, bufs, opts
+	};
+
+	const scope_count cur_reads{stats.cur_reads};
+	stats.max_reads = std::max(stats.max_reads, stats.cur_reads);
+
+	// Make request; blocks ircd::ctx until completed or throw.
+	const size_t bytes
+	{
+		request()
+	};
+
+	stats.bytes_read += bytes;
+	stats.reads++;
+	return bytes;
+}
+
+//
+// request::write
+//
+
+ircd::fs::iou::request::write::write(const int &fd,
+                                     const const_iovec_view &iov,
+                                     const write_opts &opts)
+:request{fd, &opts}
+{
+	assert(opts.op == op::WRITE);
+	opcode = IORING_OP_WRITEV;
+	this->iov = iov;
+	offset = opts.offset;
+
+	#if defined(RWF_APPEND)
+	if(support_append && opts.offset == -1)
+	{
+		offset = 0;
+		flags |= RWF_APPEND;
+	}
+	#endif
+
+	#if defined(RWF_DSYNC)
+	if(support_dsync && opts.sync && !opts.metadata)
+		flags |= RWF_DSYNC;
+	#endif
+
+	#if defined(RWF_SYNC)
+	if(support_sync && opts.sync && opts.metadata)
+		flags |= RWF_SYNC;
+	#endif
+}
+
+size_t
+ircd::fs::iou::write(const fd &fd,
+                     const const_iovec_view &bufs,
+                     const write_opts &opts)
+{
+	iou::request::write request
+	{
+		fd, bufs, opts
+	};
+
+	const scope_count cur_writes{stats.cur_writes};
+	stats.max_writes = std::max(stats.max_writes, stats.cur_writes);
+
+	// Make the request; ircd::ctx blocks here. Throws on error
+	const size_t bytes
+	{
+		request()
+	};
+
+	stats.bytes_write += bytes;
+	stats.writes++;
+	return bytes;
+}
+
+size_t
+ircd::fs::iou::count_queued(const op &type)
+{
+	assert(system);
+	const auto &qcount(system->qcount);
+	return std::count_if(begin(system->queue), begin(system->queue)+qcount, [&type]
+	(const request *const &request)
+	{
+		assert(request);
+		assert(request->opts);
+		return request->opts->op == type;
+	});
+}
+
+bool
+ircd::fs::iou::for_each_queued(const std::function<bool (const request &)> &closure)
+{
+	assert(system);
+	for(size_t i(0); i < system->qcount; ++i)
+		if(!closure(*system->queue[i]))
+			return false;
+
+	return true;
+}
+
+//
+// request
+//
+
+ircd::fs::iou::request::request(const int &fd,
+                                const struct opts *const &opts)
+:fd{fd}
+,opts{opts}
+{
+	assert(system);
+	assert(ctx::current);
+
+	#if defined(RWF_NOWAIT)
+	if(support_nowait && !opts->blocking)
+		flags |= RWF_NOWAIT;
+	#endif
+}
+
+ircd::fs::iou::request::~request()
+noexcept
+{
+}
+
+/// Cancel a request. Only requests still in our userspace queue can be
+/// canceled; the handler callstack is invoked directly from here.
+bool
+ircd::fs::iou::request::cancel()
+{
+	assert(system);
+	if(!system->cancel(*this))
+		return false;
+
+	stats.bytes_cancel += bytes(iovec());
+	stats.cancel++;
+	return true;
+}
+
+/// Submit a request and properly yield the ircd::ctx. When this returns the
+/// result will be available or an exception will be thrown.
+size_t
+ircd::fs::iou::request::operator()()
+{
+	assert(system);
+	assert(ctx::current);
+	assert(waiter == ctx::current);
+
+	const size_t submitted_bytes
+	{
+		bytes(iovec())
+	};
+
+	// Update stats for submission phase
+	stats.bytes_requests += submitted_bytes;
+	stats.requests++;
+
+	const uint16_t &curcnt(stats.requests - stats.complete);
+	stats.max_requests = std::max(stats.max_requests, curcnt);
+
+	// Wait here until there's room to submit a request
+	system->dock.wait([]
+	{
+		return system->request_avail() > 0;
+	});
+
+	// Submit to system
+	system->submit(*this);
+
+	// Wait for completion
+	while(!system->wait(*this));
+
+	assert(completed());
+	assert(retval <= ssize_t(submitted_bytes));
+
+	// Update stats for completion phase.
+	stats.bytes_complete += submitted_bytes;
+	stats.complete++;
+
+	if(likely(retval != -1))
+		return size_t(retval);
+
+	static_assert(EAGAIN == EWOULDBLOCK);
+	if(!opts->blocking && retval == -1 && errcode == EAGAIN)
+		return 0UL;
+
+	stats.errors++;
+	stats.bytes_errors += submitted_bytes;
+	thread_local char errbuf[512]; fmt::sprintf
+	{
+		errbuf, "fd:%d size:%zu off:%zd op:%u #%lu",
+		fd,
+		iov.size(),
+		offset,
+		opcode,
+		errcode
+	};
+
+	throw std::system_error
+	{
+		make_error_code(errcode), errbuf
+	};
+}
+
+bool
+ircd::fs::iou::request::queued()
+const
+{
+	return !for_each_queued([this]
+	(const auto &request)
+	{
+		return &request != this; // true to continue and return true
+	});
+}
+
+bool
+ircd::fs::iou::request::completed()
+const
+{
+	return retval >= -1L;
+}
+
+ircd::fs::const_iovec_view
+ircd::fs::iou::request::iovec()
+const
+{
+	return iov;
+}
+
+//
+// system
+//
+
+decltype(ircd::fs::iou::system::eventfd_flags)
+ircd::fs::iou::system::eventfd_flags
+{
+	EFD_CLOEXEC | EFD_NONBLOCK
+};
+
+//
+// system::system
+//
+
+ircd::fs::iou::system::system(const size_t &max_events,
+                              const size_t &max_submit)
+try
+:p{0}
+,fd
+{
+	int(syscall<SYS_io_uring_setup>(max_events, &p))
+}
+,sq_map
+{
+	map(fd, p.sq_off.array + p.sq_entries * sizeof(uint32_t), IORING_OFF_SQ_RING)
+}
+,cq_map
+{
+	p.features & IORING_FEAT_SINGLE_MMAP?
+		custom_ptr<uint8_t>{sq_map.get(), [](uint8_t *const &) {}}:
+		map(fd, p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe), IORING_OFF_CQ_RING)
+}
+,sqe
+{
+	reinterpret_cast<io_uring_sqe *>(map(fd, p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES).release()),
+	[size(p.sq_entries * sizeof(io_uring_sqe))](io_uring_sqe *const &ptr)
+	{
+		::munmap(ptr, size);
+	}
+}
+,sq_head{reinterpret_cast<uint32_t *>(sq_map.get() + p.sq_off.head)}
+,sq_tail{reinterpret_cast<uint32_t *>(sq_map.get() + p.sq_off.tail)}
+,sq_mask{reinterpret_cast<uint32_t *>(sq_map.get() + p.sq_off.ring_mask)}
+,sq_array{reinterpret_cast<uint32_t *>(sq_map.get() + p.sq_off.array)}
+,cq_head{reinterpret_cast<uint32_t *>(cq_map.get() + p.cq_off.head)}
+,cq_tail{reinterpret_cast<uint32_t *>(cq_map.get() + p.cq_off.tail)}
+,cq_mask{reinterpret_cast<uint32_t *>(cq_map.get() + p.cq_off.ring_mask)}
+,cqe{reinterpret_cast<const io_uring_cqe *>(cq_map.get() + p.cq_off.cqes)}
+,queue
+{
+	std::min(size_t(p.sq_entries), max_submit?: size_t(p.sq_entries))
+}
+,max_in_flight
+{
+	// Never allow more in flight than the completion ring can hold so the
+	// kernel never has to drop or backlog completions.
+	std::min(max_events, size_t(p.cq_entries))
+}
+,resfd
+{
+	ios::get(), int(syscall(::eventfd, ecount, eventfd_flags))
+}
+{
+	const int efd(resfd.native_handle());
+	syscall<SYS_io_uring_register>(int(fd), IORING_REGISTER_EVENTFD, &efd, 1);
+
+	log::debug
+	{
+		log, "Established io_uring fd:%d efd:%d sq:%u cq:%u features:%x max_events:%zu max_submit:%zu",
+		int(fd),
+		efd,
+		p.sq_entries,
+		p.cq_entries,
+		p.features,
+		this->max_events(),
+		this->max_submit(),
+	};
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "Error starting io_uring context %p :%s",
+		(const void *)this,
+		e.what()
+	};
+}
+
+ircd::fs::iou::system::~system()
+noexcept try
+{
+	assert(qcount == 0);
+	const ctx::uninterruptible::nothrow ui;
+
+	interrupt();
+	wait();
+
+	boost::system::error_code ec;
+	resfd.close(ec);
+}
+catch(const std::exception &e)
+{
+	log::critical
+	{
+		log, "Error shutting down io_uring context %p :%s",
+		(const void *)this,
+		e.what()
+	};
+}
+
+bool
+ircd::fs::iou::system::interrupt()
+{
+	if(!resfd.is_open())
+		return false;
+
+	if(handle_set)
+		resfd.cancel();
+	else
+		ecount = -1;
+
+	return true;
+}
+
+bool
+ircd::fs::iou::system::wait()
+{
+	if(!resfd.is_open())
+		return false;
+
+	log::debug
+	{
+		log, "Waiting for io_uring context %p", this
+	};
+
+	dock.wait([this]
+	{
+		return ecount == uint64_t(-1);
+	});
+
+	assert(request_count() == 0);
+	return true;
+}
+
+/// Block the current context while waiting for results.
+///
+/// This function returns true when the request completes and it's safe to
+/// continue. This function intercepts all exceptions and cancels the request
+/// if it's appropriate before rethrowing; after which it is safe to continue.
+///
+/// If this function returns false it is not safe to continue; it *must* be
+/// called again until it no longer returns false.
+bool
+ircd::fs::iou::system::wait(request &request)
+try
+{
+	assert(ctx::current == request.waiter);
+	while(!request.completed())
+		ctx::wait();
+
+	return true;
+}
+catch(...)
+{
+	// When the ctx is interrupted we're obliged to cancel the request
+	// if it has not reached a completed state.
+	if(request.completed())
+		throw;
+
+	// The handler callstack is invoked synchronously on this stack for
+	// requests which are still in our userspace queue.
+	if(request.queued())
+	{
+		request.cancel();
+		throw;
+	}
+
+	// Requests submitted to the kernel reference our buffers until their
+	// completion is reaped; we *must* wait for that by blocking ctx
+	// interrupts and terminations and continue to wait. The caller must
+	// loop into this call again until it returns true or throws.
+	return false;
+}
+
+bool
+ircd::fs::iou::system::cancel(request &request)
+{
+	const auto eit
+	{
+		std::remove(begin(queue), begin(queue) + qcount, &request)
+	};
+
+	const auto qcount
+	{
+		size_t(std::distance(begin(queue), eit))
+	};
+
+	if(this->qcount == qcount)
+		return false;
+
+	assert(this->qcount == qcount + 1);
+	this->qcount--;
+	dock.notify_one();
+	stats.cur_queued--;
+
+	// Setup a completion which we will handle as a normal event immediately
+	// on this stack so the handler remains agnostic to our userspace queue.
+	io_uring_cqe result {0};
+	result.user_data = uintptr_t(&request);
+	result.res = -ECANCELED;
+	handle_cqe(result);
+	return true;
+}
+
+bool
+ircd::fs::iou::system::submit(request &request)
+{
+	assert(request.opts);
+	assert(qcount < queue.size());
+	assert(qcount + in_flight < max_events());
+	assert(!request.completed());
+	const ctx::critical_assertion ca;
+
+	queue.at(qcount++) = &request;
+	stats.cur_queued++;
+	stats.max_queued = std::max(stats.max_queued, stats.cur_queued);
+	assert(stats.cur_queued == qcount);
+
+	// Determine whether this request will trigger a flush of the queue
+	// and be submitted itself as well.
+	const bool submit_now
+	{
+		// The nodelay flag is set by the user.
+		request.opts->nodelay
+
+		// The queue has reached its limits.
+		|| qcount >= max_submit()
+	};
+
+	const size_t submitted
+	{
+		submit_now? submit() : 0
+	};
+
+	// Only post the chaser when the queue has one item. If it has more
+	// items the chaser was already posted after the first item and will
+	// flush the whole queue down to 0.
+	if(qcount == 1)
+	{
+		static ios::descriptor descriptor
+		{
+			"ircd::fs::iou chase"
+		};
+
+		auto handler(std::bind(&system::chase, this));
+		ircd::defer(descriptor, std::move(handler));
+	}
+
+	return true;
+}
+
+/// The chaser is posted to the IRCd event loop after the first request.
+/// Ideally more requests will queue up before the chaser reaches the front
+/// of the IRCd event queue and executes.
+void
+ircd::fs::iou::system::chase()
+noexcept try
+{
+	if(!qcount)
+		return;
+
+	const auto submitted
+	{
+		submit()
+	};
+
+	stats.chases++;
+	assert(!qcount);
+}
+catch(const std::exception &e)
+{
+	throw panic
+	{
+		"io_uring(%p) system::chase() qcount:%zu :%s", this, qcount, e.what()
+	};
+}
+
+/// The submitter translates all queued requests into the submission ring
+/// and enters them into the kernel with one syscall, resetting our userspace
+/// queue count down to zero.
+size_t
+ircd::fs::iou::system::submit()
+noexcept try
+{
+	assert(qcount > 0);
+	assert(in_flight + qcount <= max_events());
+	const bool idle
+	{
+		in_flight == 0
+	};
+
+	const auto mask(*sq_mask);
+	auto tail(*sq_tail);
+	for(size_t i(0); i < qcount; ++i, ++tail)
+	{
+		const request &request(*queue[i]);
+		const auto idx(tail & mask);
+		io_uring_sqe &sqe(this->sqe.get()[idx]);
+		std::memset(&sqe, 0x0, sizeof(sqe));
+		sqe.opcode = request.opcode;
+		sqe.fd = request.fd;
+		sqe.off = request.offset;
+		sqe.addr = uintptr_t(request.iov.data());
+		sqe.len = request.iov.size();
+		sqe.user_data = uintptr_t(&request);
+		if(request.opcode == IORING_OP_FSYNC)
+			sqe.fsync_flags = request.flags;
+		else
+			sqe.rw_flags = request.flags;
+
+		sq_array[idx] = idx;
+	}
+
+	// Publish the entries to the kernel. From here the requests belong to
+	// the ring and are in flight whether or not they have been entered.
+	__atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+	const size_t submitted
+	{
+		qcount
+	};
+
+	sq_pending += submitted;
+	in_flight += submitted;
+	qcount = 0;
+
+	stats.submits++;
+	stats.cur_queued -= submitted;
+	stats.cur_submits += submitted;
+	stats.max_submits = std::max(stats.max_submits, stats.cur_submits);
+	assert(stats.cur_queued == qcount);
+	assert(stats.cur_submits == in_flight);
+
+	enter();
+
+	if(idle && !handle_set)
+		set_handle();
+
+	return submitted;
+}
+catch(const std::exception &e)
+{
+	ircd::terminate{ircd::error
+	{
+		"io_uring(%p) system::submit() qcount:%zu :%s",
+		this,
+		qcount,
+		e.what()
+	}};
+}
+
+/// Enter the entries published to the submission ring. The kernel may take
+/// fewer than offered, or none on a transient shortage (EAGAIN, EBUSY); a
+/// failure of any individual request is reported by its CQE. Entries not
+/// taken remain in the ring. Rather than spinning, they are entered again
+/// once completions are reaped, which releases the kernel's resources, or
+/// from the event loop when nothing in flight can complete.
+void
+ircd::fs::iou::system::enter()
+{
+	while(sq_pending)
+	{
+		const size_t entered
+		{
+			io_uring_enter(sq_pending)
+		};
+
+		if(!entered)
+			break;
+
+		assert(entered <= sq_pending);
+		sq_pending -= entered;
+	}
+
+	if(likely(!sq_pending))
+		return;
+
+	stats.retries++;
+	assert(in_flight >= sq_pending);
+	if(in_flight > sq_pending || retry_set)
+		return;
+
+	static ios::descriptor descriptor
+	{
+		"ircd::fs::iou retry"
+	};
+
+	retry_set = true;
+	auto handler(std::bind(&system::retry, this));
+	ircd::defer(descriptor, std::move(handler));
+}
+
+void
+ircd::fs::iou::system::retry()
+noexcept try
+{
+	assert(retry_set);
+	retry_set = false;
+	if(sq_pending)
+		enter();
+}
+catch(const std::exception &e)
+{
+	throw panic
+	{
+		"io_uring(%p) system::retry() pending:%zu :%s", this, sq_pending, e.what()
+	};
+}
+
+size_t
+ircd::fs::iou::system::io_uring_enter(const size_t &count)
+try
+{
+	assert(count > 0);
+
+	#ifdef RB_DEBUG
+	ctx::syscall_usage_warning warning
+	{
+		"fs::iou::system::submit(in_flight:%zu qcount:%zu)",
+		in_flight,
+		qcount,
+	};
+	#endif
+
+	const auto ret
+	{
+		syscall<SYS_io_uring_enter>(int(fd), count, 0, 0, nullptr, 0)
+	};
+
+	#ifdef RB_DEBUG
+	stats.stalls += warning.timer.stop() > 0;
+	#endif
+
+	assert(ret >= 0);
+	return ret;
+}
+catch(const std::system_error &e)
+{
+	log::error
+	{
+		log, "io_uring(%p): io_uring_enter() inflight:%zu qcount:%zu :%s",
+		this,
+		in_flight,
+		qcount,
+		e.what()
+	};
+
+	switch(e.code().value())
+	{
+		// Transient resource shortage; the entries remain in the ring and
+		// are picked up by the retry.
+		case int(std::errc::resource_unavailable_try_again):
+		case int(std::errc::device_or_resource_busy):
+			return 0;
+	}
+
+	throw;
+}
+
+void
+ircd::fs::iou::system::set_handle()
+try
+{
+	assert(!handle_set);
+	handle_set = true;
+	ecount = 0;
+
+	const asio::mutable_buffers_1 bufs
+	{
+		&ecount, sizeof(ecount)
+	};
+
+	auto handler
+	{
+		std::bind(&system::handle, this, ph::_1, ph::_2)
+	};
+
+	resfd.async_read_some(bufs, ios::handle(handle_descriptor, std::move(handler)));
+}
+catch(...)
+{
+	handle_set = false;
+	throw;
+}
+
+decltype(ircd::fs::iou::system::handle_descriptor)
+ircd::fs::iou::system::handle_descriptor
+{
+	"ircd::fs::iou sigfd",
+
+	// allocator; this handler is invoked for every batch of completions so
+	// the storage is held by the system rather than reallocated each time.
+	[](auto &handler, const size_t &size)
+	{
+		assert(ircd::fs::iou::system);
+		auto &system(*ircd::fs::iou::system);
+
+		if(unlikely(!system.handle_data))
+		{
+			system.handle_size = size;
+			system.handle_data = std::make_unique<uint8_t[]>(size);
+		}
+
+		assert(system.handle_size == size);
+		return system.handle_data.get();
+	},
+
+	// no deallocation; satisfied by class member unique_ptr
+	[](auto &handler, void *const &ptr, const auto &size) {}
+};
+
+/// Handle notifications that requests are complete.
+void
+ircd::fs::iou::system::handle(const boost::system::error_code &ec,
+                              const size_t bytes)
+noexcept try
+{
+	namespace errc = boost::system::errc;
+
+	assert((bytes == 8 && !ec && ecount >= 1) || (bytes == 0 && ec));
+	assert(!ec || ec.category() == asio::error::get_system_category());
+	assert(handle_set);
+	handle_set = false;
+
+	switch(ec.value())
+	{
+		case errc::success:
+			handle_events();
+			break;
+
+		case errc::interrupted:
+			break;
+
+		case errc::operation_canceled:
+			throw ctx::interrupted();
+
+		default:
+			throw_system_error(ec);
+	}
+
+	if(in_flight > 0 && !handle_set)
+		set_handle();
+}
+catch(const ctx::interrupted &)
+{
+	log::debug
+	{
+		log, "io_uring context %p interrupted", this
+	};
+
+	ecount = -1;
+	dock.notify_all();
+}
+
+/// Reap the completion ring. The eventfd count is only a hint; the ring
+/// itself is authoritative and is drained entirely here.
+void
+ircd::fs::iou::system::handle_events()
+noexcept try
+{
+	assert(!ctx::current);
+
+	const auto mask(*cq_mask);
+	const auto tail(__atomic_load_n(cq_tail, __ATOMIC_ACQUIRE));
+	auto head(*cq_head);
+	const size_t count(tail - head);
+	for(; head != tail; ++head)
+		handle_cqe(cqe[head & mask]);
+
+	__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+	assert(count <= in_flight);
+	in_flight -= count;
+	stats.cur_submits -= count;
+	stats.handles++;
+	if(likely(count))
+		dock.notify_one();
+
+	// Completions have released the kernel's resources; enter whatever it
+	// previously turned away.
+	if(unlikely(sq_pending))
+		enter();
+}
+catch(const std::exception &e)
+{
+	log::error
+	{
+		log, "io_uring(%p) handle_events: %s",
+		this,
+		e.what()
+	};
+}
+
+void
+ircd::fs::iou::system::handle_cqe(const io_uring_cqe &cqe)
+noexcept try
+{
+	// We referenced our request for the kernel to carry through as an
+	// opaque in `user_data`.
+	auto *const request
+	{
+		reinterpret_cast<iou::request *>(cqe.user_data)
+	};
+
+	assert(request);
+
+	// Set result indicators; the result is either a byte count or -errno.
+	request->retval = cqe.res >= 0? ssize_t(cqe.res) : -1L;
+	request->errcode = cqe.res >= 0? 0L : ssize_t(-cqe.res);
+
+	// Notify the waiting context. Note that we are on the main async stack
+	// but it is safe to notify from here.
+	assert(request->waiter);
+	ctx::notify(*request->waiter);
+	stats.events++;
+}
+catch(const std::exception &e)
+{
+	log::critical
+	{
+		log, "Unhandled request(%lu) cqe(%p) error: %s",
+		cqe.user_data,
+		&cqe,
+		e.what()
+	};
+}
+
+size_t
+ircd::fs::iou::system::request_avail()
+const
+{
+	assert(request_count() <= max_events());
+	return max_events() - request_count();
+}
+
+size_t
+ircd::fs::iou::system::request_count()
+const
+{
+	return qcount + in_flight;
+}
+
+size_t
+ircd::fs::iou::system::max_submit()
+const
+{
+	return queue.size();
+}
+
+size_t
+ircd::fs::iou::system::max_events()
+const
+{
+	return max_in_flight;
+}
+
+//
+// util
+//
+
+ircd::custom_ptr<uint8_t>
+ircd::fs::iou::map(const int &fd,
+                   const size_t &size,
+                   const off_t &off)
+{
+	void *const ptr
+	{
+		::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, off)
+	};
+
+	if(unlikely(ptr == MAP_FAILED))
+		throw_system_error(errno);
+
+	return
+	{
+		reinterpret_cast<uint8_t *>(ptr), [size](uint8_t *const &ptr)
+		{
+			::munmap(ptr, size);
+		}
+	};
+}
@@ -0,0 +1,167 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#pragma once
+#define HAVE_FS_IOU_H
+#include <linux/io_uring.h>
+
+namespace ircd::fs::iou
+{
+	struct system;
+	struct request;
+
+	size_t write(const fd &, const const_iovec_view &, const write_opts &);
+	size_t read(const fd &, const const_iovec_view &, const read_opts &);
+	void fdsync(const fd &, const sync_opts &);
+	void fsync(const fd &, const sync_opts &);
+}
+
+/// io_uring instance from the system. Like fs::aio this is a singleton with
+/// an extern instance pointer at fs::iou::system maintained by fs::iou::init.
+///
+/// Requests are queued in userspace and flushed into the submission ring all
+/// at once, either by the chaser posted to the event loop or when the queue
+/// reaches max_submit; a single io_uring_enter(2) then submits the batch.
+/// Completions are signaled on an eventfd integrated with the ircd event loop
+/// and reaped directly from the mapped completion ring.
+struct ircd::fs::iou::system
+{
+	static const int eventfd_flags;
+
+	/// io_uring_setup(2) parameters; the kernel fills in the ring offsets.
+	io_uring_params p;
+	fs::fd fd;
+
+	/// Mapped rings shared with the kernel
+	custom_ptr<uint8_t> sq_map;
+	custom_ptr<uint8_t> cq_map;
+	custom_ptr<io_uring_sqe> sqe;
+
+	uint32_t *sq_head {nullptr};
+	uint32_t *sq_tail {nullptr};
+	uint32_t *sq_mask {nullptr};
+	uint32_t *sq_array {nullptr};
+	uint32_t *cq_head {nullptr};
+	uint32_t *cq_tail {nullptr};
+	uint32_t *cq_mask {nullptr};
+	const io_uring_cqe *cqe {nullptr};
+
+	/// Userspace submission queue (out)
+	std::vector<request *> queue;
+	size_t qcount {0};
+
+	/// other state
+	ctx::dock dock;
+	size_t in_flight {0};
+	size_t max_in_flight {0};
+	size_t sq_pending {0}; // published to the ring, not yet entered
+	bool handle_set {false};
+	bool retry_set {false};
+
+	size_t handle_size {0};
+	std::unique_ptr<uint8_t[]> handle_data;
+	static ios::descriptor handle_descriptor;
+
+	/// Registered with the ring with IORING_REGISTER_EVENTFD; we integrate this
+	/// with the ircd io_service core epoll() event loop. The semaphore value
+	/// is read into ecount.
+	uint64_t ecount {0};
+	asio::posix::stream_descriptor resfd;
+
+	size_t max_events() const;
+	size_t max_submit() const;
+	size_t request_count() const; // qcount + in_flight
+	size_t request_avail() const; // max_events - request_count()
+
+	// Callback stack invoked when the eventfd is notified of completions.
+	void handle_cqe(const io_uring_cqe &) noexcept;
+	void handle_events() noexcept;
+	void handle(const boost::system::error_code &, const size_t) noexcept;
+	void set_handle();
+
+	size_t io_uring_enter(const size_t &count);
+	void enter();
+	size_t submit() noexcept;
+	void chase() noexcept;
+	void retry() noexcept;
+
+	bool submit(request &);
+	bool cancel(request &);
+	bool wait(request &);
+
+	// Control panel
+	bool wait();
+	bool interrupt();
+
+	system(const size_t &max_events,
+	       const size_t &max_submit);
+
+	~system() noexcept;
+};
+
+/// Generic request control block. This is translated into an SQE when the
+/// system flushes its userspace queue into the submission ring.
+struct ircd::fs::iou::request
+{
+	struct read;
+	struct write;
+	struct fdsync;
+	struct fsync;
+
+	int fd {-1};
+	uint8_t opcode {IORING_OP_NOP};
+	uint32_t flags {0}; // rw_flags or fsync_flags
+	off_t offset {0};
+	const_iovec_view iov;
+
+	ssize_t retval {-2L};
+	ssize_t errcode {0L};
+	const struct opts *opts {nullptr};
+	ctx::ctx *waiter {ctx::current};
+
+  public:
+	const_iovec_view iovec() const;
+	bool completed() const;
+	bool queued() const;
+
+	size_t operator()();
+	bool cancel();
+
+	request(const int &fd, const struct opts *const &);
+	~request() noexcept;
+};
+
+/// Read request control block
+struct ircd::fs::iou::request::read
+:request
+{
+	read(const int &fd, const const_iovec_view &, const read_opts &);
+};
+
+/// Write request control block
+struct ircd::fs::iou::request::write
+:request
+{
+	write(const int &fd, const const_iovec_view &, const write_opts &);
+};
+
+/// fdsync request control block
+struct ircd::fs::iou::request::fdsync
+:request
+{
+	fdsync(const int &fd, const sync_opts &);
+};
+
+/// fsync request control block
+struct ircd::fs::iou::request::fsync
+:request
+{
+	fsync(const int &fd, const sync_opts &);
+};
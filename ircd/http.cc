@@ -317,6 +317,10 @@ ircd::http::request::head::head(parse::capstan &pc,
 			this->content_type = h.second;
 		else if(iequals(h.first, "user-agent"_sv))
 			this->user_agent = h.second;
+		else if(iequals(h.first, "accept-encoding"_sv))
+			this->accept_encoding = h.second;
+		else if(iequals(h.first, "content-encoding"_sv))
+			this->content_encoding = h.second;
 
 		if(c)
 			c(h);
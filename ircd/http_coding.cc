@@ -0,0 +1,546 @@
+// Matrix Construct
+//
+// Copyright (C) Matrix Construct Developers, Authors & Contributors
+// Copyright (C) 2016-2019 Jason Volk <jason@zemos.net>
+//
+// Permission to use, copy, modify, and/or distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice is present in all copies. The
+// full license for this software is available in the LICENSE file.
+
+#include <RB_INC_ZLIB_H
+#include <RB_INC_ZSTD_H
+
+/// Codec state behind the encoder. Only the member for the encoder's type is
+/// initialized.
+struct ircd::http::coding::encoder::state
+{
+	coding::type type {IDENTITY};
+
+	#ifdef HAVE_ZLIB_H
+	z_stream z {0};
+	#endif
+
+	#ifdef HAVE_ZSTD_H
+	ZSTD_CCtx *zc {nullptr};
+	#endif
+
+	size_t gzip(const const_buffer &, const flush &, const mutable_buffer &, const closure &);
+	size_t zstd(const const_buffer &, const flush &, const mutable_buffer &, const closure &);
+
+	state(const coding::type &, const int &level, const int &window);
+	state(state &&) = delete;
+	state(const state &) = delete;
+	~state() noexcept;
+};
+
+//
+// coding::encoder
+//
+
+ircd::http::coding::encoder::encoder()
+= default;
+
+ircd::http::coding::encoder::encoder(encoder &&)
+noexcept = default;
+
+ircd::http::coding::encoder &
+ircd::http::coding::encoder::operator=(encoder &&)
+noexcept = default;
+
+ircd::http::coding::encoder::~encoder()
+noexcept
+{
+}
+
+ircd::http::coding::encoder::encoder(const coding::type &type,
+                                     const int &level,
+                                     const int &window,
+                                     const size_t &buffer_size)
+:type
+{
+	type
+}
+,buf
+{
+	type != IDENTITY? buffer_size : 0UL
+}
+,s
+{
+	type != IDENTITY?
+		std::make_unique<state>(type, level, window):
+		nullptr
+}
+{
+	assert(type == IDENTITY || buffer_size);
+}
+
+/// Returns the number of bytes of output passed to the closure.
+size_t
+ircd::http::coding::encoder::operator()(const const_buffer &in,
+                                        const flush &mode,
+                                        const closure &closure)
+{
+	switch(type)
+	{
+		case GZIP:
+			assert(s);
+			return s->gzip(in, mode, buf, closure);
+
+		case ZSTD:
+			assert(s);
+			return s->zstd(in, mode, buf, closure);
+
+		default:
+			if(!empty(in))
+				closure(in);
+
+			return size(in);
+	}
+}
+
+//
+// coding::encoder::state
+//
+
+ircd::http::coding::encoder::state::state(const coding::type &type,
+                                          const int &level,
+                                          const int &window)
+:type{type}
+{
+	if(!available(type))
+		throw error
+		{
+			NOT_IMPLEMENTED, fmt::snstringf
+			{
+				64, "Content-Coding '%s' is not available.",
+				reflect(type)
+			}
+		};
+
+	#ifdef HAVE_ZLIB_H
+	if(type == GZIP)
+	{
+		// zlib's state is (1 << (window + 2)) + (1 << (mem_level + 9)) bytes;
+		// the mem_level is scaled down with the window to keep the bound.
+		const int window_bits
+		{
+			std::clamp(window, 9, 15)
+		};
+
+		const int mem_level
+		{
+			std::clamp(window_bits - 7, 1, 8)
+		};
+
+		// Adding 16 to the window bits selects the gzip wrapper.
+		const int ret
+		{
+			deflateInit2(&z, std::clamp(level, 0, 9), Z_DEFLATED, 16 + window_bits, mem_level, Z_DEFAULT_STRATEGY)
+		};
+
+		if(unlikely(ret != Z_OK))
+			throw error
+			{
+				INTERNAL_SERVER_ERROR, fmt::snstringf
+				{
+					128, "gzip :%s", z.msg?: "initialization failed"
+				}
+			};
+	}
+	#endif
+
+	#ifdef HAVE_ZSTD_H
+	if(type == ZSTD)
+	{
+		zc = ZSTD_createCCtx();
+		if(unlikely(!zc))
+			throw std::bad_alloc{};
+
+		ZSTD_CCtx_setParameter(zc, ZSTD_c_compressionLevel, level);
+		ZSTD_CCtx_setParameter(zc, ZSTD_c_windowLog, std::clamp(window, int(ZSTD_WINDOWLOG_MIN), 24));
+	}
+	#endif
+}
+
+ircd::http::coding::encoder::state::~state()
+noexcept
+{
+	#ifdef HAVE_ZLIB_H
+	if(type == GZIP)
+		deflateEnd(&z);
+	#endif
+
+	#ifdef HAVE_ZSTD_H
+	if(type == ZSTD)
+		ZSTD_freeCCtx(zc);
+	#endif
+}
+
+size_t
+ircd::http::coding::encoder::state::gzip(const const_buffer &in,
+                                         const flush &mode,
+                                         const mutable_buffer &buf,
+                                         const closure &closure)
+{
+	size_t ret(0);
+
+	#ifdef HAVE_ZLIB_H
+	const int zflush
+	{
+		mode == FINISH? Z_FINISH:
+		mode == SYNC?   Z_SYNC_FLUSH:
+		                Z_NO_FLUSH
+	};
+
+	z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data(in)));
+	z.avail_in = size(in);
+	do
+	{
+		z.next_out = reinterpret_cast<Bytef *>(data(buf));
+		z.avail_out = size(buf);
+		const int res
+		{
+			::deflate(&z, zflush)
+		};
+
+		// Z_BUF_ERROR only indicates no progress was possible; not fatal.
+		if(unlikely(res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR))
+			throw error
+			{
+				INTERNAL_SERVER_ERROR, fmt::snstringf
+				{
+					128, "gzip :%s", z.msg?: "stream error"
+				}
+			};
+
+		const size_t produced
+		{
+			size(buf) - z.avail_out
+		};
+
+		if(produced)
+			closure(const_buffer{data(buf), produced});
+
+		ret += produced;
+		if(res == Z_STREAM_END || res == Z_BUF_ERROR)
+			break;
+	}
+	while(z.avail_out == 0 || z.avail_in > 0);
+	#endif
+
+	return ret;
+}
+
+size_t
+ircd::http::coding::encoder::state::zstd(const const_buffer &in,
+                                         const flush &mode,
+                                         const mutable_buffer &buf,
+                                         const closure &closure)
+{
+	size_t ret(0);
+
+	#ifdef HAVE_ZSTD_H
+	const ZSTD_EndDirective directive
+	{
+		mode == FINISH? ZSTD_e_end:
+		mode == SYNC?   ZSTD_e_flush:
+		                ZSTD_e_continue
+	};
+
+	ZSTD_inBuffer zin
+	{
+		data(in), size(in), 0
+	};
+
+	while(1)
+	{
+		ZSTD_outBuffer zout
+		{
+			data(buf), size(buf), 0
+		};
+
+		const size_t remain
+		{
+			ZSTD_compressStream2(zc, &zout, &zin, directive)
+		};
+
+		if(unlikely(ZSTD_isError(remain)))
+			throw error
+			{
+				INTERNAL_SERVER_ERROR, fmt::snstringf
+				{
+					128, "zstd :%s", ZSTD_getErrorName(remain)
+				}
+			};
+
+		if(zout.pos)
+			closure(const_buffer{data(buf), zout.pos});
+
+		ret += zout.pos;
+		const bool done
+		{
+			directive == ZSTD_e_continue?
+				zin.pos == zin.size:
+				remain == 0
+		};
+
+		if(done)
+			break;
+	}
+	#endif
+
+	return ret;
+}
+
+//
+// coding
+//
+
+/// Decode the entire input into the buffer. Throws PAYLOAD_TOO_LARGE when
+/// the decoded content does not fit and BAD_REQUEST for a malformed input.
+ircd::string_view
+ircd::http::coding::decode(const mutable_buffer &out,
+                           const const_buffer &in,
+                           const type &type)
+{
+	switch(type)
+	{
+		case IDENTITY:
+		{
+			if(unlikely(size(in) > size(out)))
+				throw error
+				{
+					PAYLOAD_TOO_LARGE
+				};
+
+			return string_view
+			{
+				data(out), copy(out, in)
+			};
+		}
+
+		#ifdef HAVE_ZLIB_H
+		case GZIP:
+		{
+			z_stream z {0};
+			z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data(in)));
+			z.avail_in = size(in);
+			z.next_out = reinterpret_cast<Bytef *>(data(out));
+			z.avail_out = size(out);
+
+			// Adding 16 to the window bits accepts only the gzip wrapper.
+			if(unlikely(inflateInit2(&z, 16 + MAX_WBITS) != Z_OK))
+				throw error
+				{
+					INTERNAL_SERVER_ERROR
+				};
+
+			const unwind end{[&z]
+			{
+				inflateEnd(&z);
+			}};
+
+			const int res
+			{
+				inflate(&z, Z_FINISH)
+			};
+
+			if(res == Z_BUF_ERROR && z.avail_out == 0)
+				throw error
+				{
+					PAYLOAD_TOO_LARGE
+				};
+
+			if(res != Z_STREAM_END)
+				throw error
+				{
+					BAD_REQUEST, fmt::snstringf
+					{
+						128, "gzip :%s", z.msg?: "truncated content"
+					}
+				};
+
+			return string_view
+			{
+				data(out), size(out) - z.avail_out
+			};
+		}
+		#endif
+
+		#ifdef HAVE_ZSTD_H
+		case ZSTD:
+		{
+			const size_t res
+			{
+				ZSTD_decompress(data(out), size(out), data(in), size(in))
+			};
+
+			if(ZSTD_isError(res) && ZSTD_getErrorCode(res) == ZSTD_error_dstSize_tooSmall)
+				throw error
+				{
+					PAYLOAD_TOO_LARGE
+				};
+
+			if(ZSTD_isError(res))
+				throw error
+				{
+					BAD_REQUEST, fmt::snstringf
+					{
+						128, "zstd :%s", ZSTD_getErrorName(res)
+					}
+				};
+
+			return string_view
+			{
+				data(out), res
+			};
+		}
+		#endif
+
+		default:
+			throw error
+			{
+				UNSUPPORTED_MEDIA_TYPE
+			};
+	}
+}
+
+/// Select the coding for a response from the Accept-Encoding of a request.
+/// The available coding with the highest qvalue is chosen; among equal
+/// qvalues ZSTD is preferred over GZIP. Returns IDENTITY when nothing is
+/// acceptable.
+ircd::http::coding::type
+ircd::http::coding::negotiate(const string_view &accept_encoding)
+noexcept
+{
+	// Negative for codings the client did not mention.
+	float q[_NUM_] {-1.0f, -1.0f, -1.0f};
+	float wildcard {0.0f};
+	tokens(accept_encoding, ',', [&q, &wildcard]
+	(const string_view &token)
+	{
+		const auto &[name_, params]
+		{
+			split(token, ';')
+		};
+
+		const auto &[key, val]
+		{
+			split(strip(params), '=')
+		};
+
+		float qvalue {1.0f};
+		if(iequals(strip(key), "q"_sv)) try
+		{
+			qvalue = lex_cast<double>(strip(val));
+		}
+		catch(const bad_lex_cast &)
+		{
+			qvalue = 0.0f;
+		}
+
+		const auto name
+		{
+			strip(name_)
+		};
+
+		if(name == "*")
+			wildcard = qvalue;
+		else if(iequals(name, "gzip"_sv) || iequals(name, "x-gzip"_sv))
+			q[GZIP] = qvalue;
+		else if(iequals(name, "zstd"_sv))
+			q[ZSTD] = qvalue;
+	});
+
+	type ret {IDENTITY};
+	float best {0.0f};
+	for(const auto &t : {ZSTD, GZIP})
+	{
+		const float qvalue
+		{
+			q[t] >= 0.0f? q[t] : wildcard
+		};
+
+		if(available(t) && qvalue > best)
+		{
+			ret = t;
+			best = qvalue;
+		}
+	}
+
+	return ret;
+}
+
+/// Parse a Content-Encoding header value. Stacked codings are not supported.
+/// Throws UNSUPPORTED_MEDIA_TYPE if the coding is not available here.
+ircd::http::coding::type
+ircd::http::coding::parse(const string_view &content_encoding)
+{
+	const auto name
+	{
+		strip(content_encoding)
+	};
+
+	const type ret
+	{
+		!name || iequals(name, "identity"_sv)?
+			IDENTITY:
+		iequals(name, "gzip"_sv) || iequals(name, "x-gzip"_sv)?
+			GZIP:
+		iequals(name, "zstd"_sv)?
+			ZSTD:
+			_NUM_
+	};
+
+	if(ret == _NUM_ || !available(ret))
+		throw error
+		{
+			UNSUPPORTED_MEDIA_TYPE, fmt::snstringf
+			{
+				128, "Content-Encoding '%s' is not supported.",
+				trunc(name, 64)
+			}
+		};
+
+	return ret;
+}
+
+ircd::string_view
+ircd::http::coding::reflect(const type &type)
+noexcept
+{
+	switch(type)
+	{
+		case IDENTITY:  return "identity";
+		case GZIP:      return "gzip";
+		case ZSTD:      return "zstd";
+		case _NUM_:     break;
+	}
+
+	return "?????";
+}
+
+bool
+ircd::http::coding::available(const type &type)
+noexcept
+{
+	switch(type)
+	{
+		case IDENTITY:
+			return true;
+
+		#ifdef HAVE_ZLIB_H
+		case GZIP:
+			return true;
+		#endif
+
+		#ifdef HAVE_ZSTD_H
+		case ZSTD:
+			return true;
+		#endif
+
+		default:
+			return false;
+	}
+}
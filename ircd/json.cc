@@ -8,14 +8,26 @@
 // copyright notice and this permission notice is present in all copies. The
 // full license for this software is available in the LICENSE file.
 
+#include <RB_INC_X86INTRIN_H
+
 namespace ircd { namespace json
 __attribute__((visibility("hidden")))
 {
 	using namespace ircd::spirit;
 
+	struct scanner;
 	struct input;
 	struct output;
 
+	// Structural scanner
+	template<char... c> static const char *scan_find(const char *, const char *const &) noexcept;
+	static const char *scan_string(const char *, const char *const &) noexcept;
+	static bool scan_chars(const char *, const char *const &) noexcept;
+	static const char *scan_container(const char *, const char *const &) noexcept;
+	static const char *scan_value(const char *, const char *const &) noexcept;
+
+	extern conf::item<bool> scan_enable;
+
 	// Instantiations of the grammars
 	struct parser extern const parser;
 	struct printer extern const printer;
@@ -37,6 +49,49 @@ BOOST_FUSION_ADAPT_STRUCT
     ( decltype(ircd::json::object::member::second),  second )
 )
 
+/// Grammar primitive matching the string, object or array at the front of
+/// the input using the structural scanner rather than the grammar. It fails
+/// without consuming anything for other values, when disabled, or when the
+/// scanner can't delimit the value, so it is always followed by the grammar
+/// as an alternative which then parses (or rejects) the value as before.
+struct ircd::json::scanner
+:qi::primitive_parser<scanner>
+{
+	template<class context,
+	         class iterator>
+	struct attribute
+	{
+		using type = unused_type;
+	};
+
+	template<class iterator,
+	         class context,
+	         class skipper,
+	         class attr>
+	bool parse(iterator &start, const iterator &stop, context &, const skipper &, attr &) const
+	{
+		if(!scan_enable)
+			return false;
+
+		const char *const ret
+		{
+			scan_value(start, stop)
+		};
+
+		if(!ret)
+			return false;
+
+		start = ret;
+		return true;
+	}
+
+	template<class context>
+	boost::spirit::info what(context &) const
+	{
+		return boost::spirit::info{"scanned value"};
+	}
+};
+
 struct ircd::json::input
 :qi::grammar<const char *, unused_type>
 {
@@ -155,6 +210,9 @@ struct ircd::json::input
 		,"value"
 	};
 
+	// value delimited by the structural scanner when possible
+	const json::scanner scanner {};
+
 	rule<enum json::type> type
 	{
 		(omit[quote]           >> attr(json::STRING))  |
@@ -1013,6 +1071,42 @@ ircd::json::stack::object::append(const json::object &object)
 		};
 }
 
+/// Copies the members of an already strung object verbatim into this object
+/// without visiting each member. The caller is responsible for the members
+/// not conflicting with any others appended to this object.
+void
+ircd::json::stack::object::splice(const json::object &object)
+{
+	assert(s);
+	assert(cm == nullptr);
+	s->rethrow_exception();
+
+	static const string_view ws
+	{
+		" \t\r\n"
+	};
+
+	string_view members
+	{
+		lstripa(rstripa(string_view{object}, ws), ws)
+	};
+
+	members = lstrip(rstrip(members, "}"_sv, 1), "{"_sv, 1);
+	members = lstripa(rstripa(members, ws), ws);
+	if(empty(members))
+		return;
+
+	if(mc)
+		s->append(","_sv);
+
+	// Very large objects are written in pieces so the stack may flush.
+	const size_t max(size(s->buf.base));
+	for(size_t off(0); off < size(members); off += max)
+		s->append(members.substr(off, max));
+
+	mc++;
+}
+
 ircd::json::stack::object::~object()
 noexcept
 {
@@ -2414,7 +2508,7 @@ const try
 
 	static const parser::rule<json::object::member> object_member
 	{
-		parser.name >> -ws >> parser.name_sep >> -ws >> raw[parser.value(0)]
+		parser.name >> -ws >> parser.name_sep >> -ws >> raw[parser.scanner | parser.value(0)]
 		,"object member"
 	};
 
@@ -2511,7 +2605,7 @@ try
 
 	static const parser::rule<json::object::member> member
 	{
-		parser.name >> -ws >> parser.name_sep >> -ws >> raw[parser.value(0)]
+		parser.name >> -ws >> parser.name_sep >> -ws >> raw[parser.scanner | parser.value(0)]
 		,"next object member"
 	};
 
@@ -2807,7 +2901,7 @@ const try
 
 	static const parser::rule<string_view> value
 	{
-		raw[parser.value(0)]
+		raw[parser.scanner | parser.value(0)]
 		,"array element"
 	};
 
@@ -2916,7 +3010,7 @@ try
 
 	static const parser::rule<string_view> value
 	{
-		raw[parser.value(0)]
+		raw[parser.scanner | parser.value(0)]
 		,"array element"
 	};
 
@@ -4016,6 +4110,272 @@ static_assert
 	ircd::json::undefined_number != 0
 );
 
+//
+// scanner
+//
+
+#if defined(__AVX2__)
+decltype(ircd::json::scan_isa)
+ircd::json::scan_isa
+{
+	"avx2"
+};
+#elif defined(__SSE4_2__)
+decltype(ircd::json::scan_isa)
+ircd::json::scan_isa
+{
+	"sse4.2"
+};
+#else
+decltype(ircd::json::scan_isa)
+ircd::json::scan_isa
+{
+	"scalar"
+};
+#endif
+
+/// Clearing this reverts the object and array iterators to the grammar for
+/// comparison; see the console's `json bench`.
+decltype(ircd::json::scan_enable)
+ircd::json::scan_enable
+{
+	{ "name",     "ircd.json.scan.enable" },
+	{ "default",  true                    },
+};
+
+ircd::string_view
+ircd::json::scan(const string_view &s)
+noexcept
+{
+	const char *const ret
+	{
+		scan_value(begin(s), end(s))
+	};
+
+	return ret?
+		string_view{begin(s), ret}:
+		string_view{};
+}
+
+/// Delimits the string, object or array starting at `it`; returns a pointer
+/// to one past its end. Returns null for any other value or if the value
+/// can't be delimited: unterminated, mismatched brackets, or nested deeper
+/// than the grammar allows, or a string the grammar would reject. Only the
+/// structure of a container is examined; the content of strings and scalars
+/// within it is validated when the container itself is iterated.
+const char *
+ircd::json::scan_value(const char *const it,
+                       const char *const &stop)
+noexcept
+{
+	if(unlikely(it >= stop))
+		return nullptr;
+
+	switch(*it)
+	{
+		case '"':
+		{
+			const char *const ret
+			{
+				scan_string(it, stop)
+			};
+
+			return ret && scan_chars(it + 1, ret - 1)?
+				ret:
+				nullptr;
+		}
+
+		case '{':
+		case '[':
+			return scan_container(it, stop);
+
+		default:
+			return nullptr;
+	}
+}
+
+const char *
+ircd::json::scan_container(const char *it,
+                           const char *const &stop)
+noexcept
+{
+	static const uint max_depth
+	{
+		std::min(uint(object::max_recursion_depth), uint(array::max_recursion_depth))
+	};
+
+	// One bit for each level of depth; set for an object, clear for array.
+	uint64_t type(0);
+	uint depth(0);
+	while((it = scan_find<'"', '{', '}', '[', ']'>(it, stop)) < stop)
+		switch(*it)
+		{
+			case '"':
+				if(!(it = scan_string(it, stop)))
+					return nullptr;
+
+				continue;
+
+			case '{':
+			case '[':
+				if(unlikely(depth + 1 >= max_depth))
+					return nullptr;
+
+				type = (type << 1) | (*it == '{');
+				++depth;
+				++it;
+				continue;
+
+			default:
+				if(unlikely(!depth || (type & 1) != (*it == '}')))
+					return nullptr;
+
+				type >>= 1;
+				++it;
+				if(--depth == 0)
+					return it;
+
+				continue;
+		}
+
+	return nullptr;
+}
+
+const char *
+ircd::json::scan_string(const char *it,
+                        const char *const &stop)
+noexcept
+{
+	assert(*it == '"');
+	++it;
+	while((it = scan_find<'"', '\\'>(it, stop)) < stop)
+	{
+		if(*it == '"')
+			return it + 1;
+
+		// Skip the escape and the character it escapes.
+		if(unlikely(++it == stop))
+			break;
+
+		++it;
+	}
+
+	return nullptr;
+}
+
+/// Validates the characters between the quotes of a string delimited by
+/// scan_string() as the grammar does: the control characters which must be
+/// escaped can't appear raw, and only the escapes it recognizes are allowed.
+bool
+ircd::json::scan_chars(const char *it,
+                       const char *const &stop)
+noexcept
+{
+	static const auto xdigit{[](const char &c)
+	{
+		return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+	}};
+
+	while((it = scan_find<'\\', '\b', '\f', '\n', '\r', '\t', '\0'>(it, stop)) < stop)
+	{
+		if(*it != '\\' || ++it == stop)
+			return false;
+
+		switch(*it++)
+		{
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+			case '0':
+				continue;
+
+			case 'u':
+			{
+				size_t i(0);
+				for(; i < 12 && it < stop && xdigit(*it); ++i, ++it);
+				if(unlikely(!i))
+					return false;
+
+				continue;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/// Find the first of the characters c... in the input; returns stop if none.
+/// The input is compared a block of 32 (AVX2) or 16 (SSE4.2) bytes at a time
+/// with any remainder compared one byte at a time.
+template<char... c>
+const char *
+ircd::json::scan_find(const char *it,
+                      const char *const &stop)
+noexcept
+{
+	#if defined(__AVX2__)
+	for(; it + 32 <= stop; it += 32)
+	{
+		const __m256i block
+		{
+			_mm256_loadu_si256(reinterpret_cast<const __m256i *>(it))
+		};
+
+		__m256i match
+		{
+			_mm256_setzero_si256()
+		};
+
+		((match = _mm256_or_si256(match, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)))), ...);
+		const uint32_t mask(_mm256_movemask_epi8(match));
+		if(mask)
+			return it + __builtin_ctz(mask);
+	}
+	#elif defined(__SSE4_2__)
+	alignas(16) static const char set[16]
+	{
+		c...
+	};
+
+	const __m128i chars
+	{
+		_mm_load_si128(reinterpret_cast<const __m128i *>(set))
+	};
+
+	for(; it + 16 <= stop; it += 16)
+	{
+		const __m128i block
+		{
+			_mm_loadu_si128(reinterpret_cast<const __m128i *>(it))
+		};
+
+		// The explicit lengths are used so a NUL in the input is not taken
+		// as a terminator.
+		const int pos
+		{
+			_mm_cmpestri(chars, sizeof...(c), block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT)
+		};
+
+		if(pos < 16)
+			return it + pos;
+	}
+	#endif
+
+	for(; it < stop; ++it)
+		if(((*it == c) || ...))
+			return it;
+
+	return stop;
+}
+
 ircd::string_view
 ircd::json::escape(const mutable_buffer &buf,
                    const string_view &in)
@@ -1470,8 +1470,71 @@ ircd::m::vm::eval::eval(const json::array &event,
 :opts{&opts}
 ,pdus{event}
 {
+	// Signature verification for the whole array is performed up front in
+	// parallel; each pdu's result is then consulted by execute_pdu(). A pdu
+	// which has already been evaluated is rejected by execute_pdu() before
+	// its result is consulted, so it is left out of the batch.
+	const size_t count
+	{
+		opts.verify? size_t(this->pdus.count()) : 0UL
+	};
+
+	const std::unique_ptr<bool[]> mask
+	{
+		count? new bool[count]{false} : nullptr
+	};
+
+	if(count)
+	{
+		std::vector<json::object> batch;
+		std::vector<size_t> slot;
+		batch.reserve(count);
+		slot.reserve(count);
+
+		size_t i(0);
+		for(const json::object &pdu : this->pdus)
+		{
+			const auto &event_id
+			{
+				unquote(pdu.get("event_id"))
+			};
+
+			const bool known
+			{
+				!opts.replays &&
+				valid(m::id::EVENT, event_id) &&
+				exists(m::event::id{event_id})
+			};
+
+			if(!known)
+			{
+				batch.emplace_back(pdu);
+				slot.emplace_back(i);
+			}
+
+			++i;
+		}
+
+		const std::unique_ptr<bool[]> result
+		{
+			new bool[batch.size()]
+		};
+
+		m::verify(batch, vector_view<bool>(result.get(), batch.size()));
+		for(size_t j(0); j < slot.size(); ++j)
+			mask[slot[j]] = result[j];
+	}
+
+	size_t i(0);
 	for(const json::object &pdu : this->pdus)
+	{
+		const scope_restore verified_
+		{
+			this->verified, count? mask.get() + i++ : nullptr
+		};
+
 		operator()(pdu);
+	}
 }
 
 ircd::m::vm::eval::eval(const vm::copts &opts)
@@ -2291,7 +2354,15 @@ ircd::m::node::key(const string_view &key_id,
                    const ed25519_closure &closure)
 const
 {
-	key(key_id, key_closure{[&closure]
+	const auto &origin
+	{
+		node_id.hostname()
+	};
+
+	if(key_cache::get(origin, key_id, closure))
+		return;
+
+	key(key_id, key_closure{[&closure, &origin, &key_id]
 	(const string_view &keyb64)
 	{
 		const ed25519::pk pk
@@ -2302,6 +2373,7 @@ const
 			}
 		};
 
+		key_cache::set(origin, key_id, pk);
 		closure(pk);
 	}});
 }
@@ -2338,6 +2410,133 @@ const
 	});
 }
 
+//
+// node::key_cache
+//
+
+namespace ircd::m
+{
+	static size_t key_cache_hash(const string_view &origin, const string_view &key_id);
+}
+
+decltype(ircd::m::node::key_cache::max)
+ircd::m::node::key_cache::max
+{
+	{ "name",     "ircd.m.node.key_cache.max" },
+	{ "default",  16384L                      },
+};
+
+decltype(ircd::m::node::key_cache::ttl)
+ircd::m::node::key_cache::ttl
+{
+	{ "name",     "ircd.m.node.key_cache.ttl" },
+	{ "default",  3600L                       },
+};
+
+decltype(ircd::m::node::key_cache::hits)
+ircd::m::node::key_cache::hits
+{
+	{ "name", "ircd.m.node.key_cache.hits" },
+};
+
+decltype(ircd::m::node::key_cache::misses)
+ircd::m::node::key_cache::misses
+{
+	{ "name", "ircd.m.node.key_cache.misses" },
+};
+
+decltype(ircd::m::node::key_cache::map)
+ircd::m::node::key_cache::map;
+
+void
+ircd::m::node::key_cache::clear()
+{
+	map.clear();
+}
+
+bool
+ircd::m::node::key_cache::clear(const string_view &origin,
+                                const string_view &key_id)
+{
+	const auto it
+	{
+		map.find(key_cache_hash(origin, key_id))
+	};
+
+	if(it == end(map) || it->second.origin != origin || it->second.key_id != key_id)
+		return false;
+
+	map.erase(it);
+	return true;
+}
+
+/// When the table is full an arbitrary entry is evicted.
+void
+ircd::m::node::key_cache::set(const string_view &origin,
+                              const string_view &key_id,
+                              const ed25519::pk &pk)
+{
+	if(!size_t(max))
+		return;
+
+	const auto key
+	{
+		key_cache_hash(origin, key_id)
+	};
+
+	if(!map.count(key) && map.size() >= size_t(max))
+		map.erase(begin(map));
+
+	entry &e(map[key]);
+	e.origin = std::string{origin};
+	e.key_id = std::string{key_id};
+	e.pk = pk;
+	e.expires = now<steady_point>() + seconds(ttl);
+}
+
+/// Invokes the closure with the key and returns true if it's cached.
+bool
+ircd::m::node::key_cache::get(const string_view &origin,
+                              const string_view &key_id,
+                              const ed25519_closure &closure)
+{
+	const auto it
+	{
+		map.find(key_cache_hash(origin, key_id))
+	};
+
+	if(it == end(map) || it->second.origin != origin || it->second.key_id != key_id)
+	{
+		misses += 1;
+		return false;
+	}
+
+	if(it->second.expires < now<steady_point>())
+	{
+		map.erase(it);
+		misses += 1;
+		return false;
+	}
+
+	// Copied so the closure is free to make further lookups.
+	const ed25519::pk pk
+	{
+		it->second.pk
+	};
+
+	hits += 1;
+	closure(pk);
+	return true;
+}
+
+size_t
+ircd::m::key_cache_hash(const string_view &origin,
+                        const string_view &key_id)
+{
+	const std::hash<string_view> hash;
+	return hash(origin) ^ (hash(key_id) * 0x100000001b3UL);
+}
+
 /// Generates a node-room ID into buffer; see room_id() overload.
 ircd::m::id::room::buf
 ircd::m::node::room_id()
@@ -2412,15 +2611,27 @@ ircd::m::events::for_each(const range &range,
 	});
 }
 
+decltype(ircd::m::events::prefetch_window)
+ircd::m::events::prefetch_window
+{
+	{ "name",     "ircd.m.events.prefetch.window" },
+	{ "default",  16L                             },
+};
+
 bool
 ircd::m::events::for_each(const range &range,
                           const closure_bool &closure)
 {
-	event::fetch event
+	const auto &fopts
 	{
 		range.fopts? *range.fopts : event::fetch::default_opts
 	};
 
+	event::fetch event
+	{
+		fopts
+	};
+
 	const bool ascending
 	{
 		range.first <= range.second
@@ -2440,10 +2651,25 @@ ircd::m::events::for_each(const range &range,
 			range.second
 	};
 
+	// The indexes are sequential so the readahead simply runs ahead of the
+	// cursor in the same direction.
+	db::prefetcher prefetcher
+	{
+		size_t(prefetch_window)
+	};
+
+	auto ra(start);
 	for(; start != stop; ascending? ++start : --start)
+	{
+		consume(prefetcher, start);
+		for(; ra != stop && !prefetcher.full(); ascending? ++ra : --ra)
+			if(ra != start && !prefetch(prefetcher, ra, fopts))
+				break;
+
 		if(seek(event, start, std::nothrow))
 			if(!closure(start, event))
 				return false;
+	}
 
 	return true;
 }
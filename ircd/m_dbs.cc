@@ -71,6 +71,16 @@ decltype(ircd::m::dbs::state_node)
 ircd::m::dbs::state_node
 {};
 
+/// Linkage for a reference to the room_sync column.
+decltype(ircd::m::dbs::room_sync)
+ircd::m::dbs::room_sync
+{};
+
+/// Linkage for a reference to the node_send column.
+decltype(ircd::m::dbs::node_send)
+ircd::m::dbs::node_send
+{};
+
 /// Coarse variable for enabling the uncompressed cache on the events database;
 /// note this conf item is only effective by setting an environmental variable
 /// before daemon startup. It has no effect in any other regard.
@@ -157,6 +167,16 @@ ircd::m::dbs::init::init(std::string dbopts)
 	room_joined = db::index{*events, desc::events__room_joined.name};
 	room_state = db::index{*events, desc::events__room_state.name};
 	state_node = db::column{*events, desc::events__state_node.name};
+	room_sync = db::index{*events, desc::events__room_sync.name};
+	node_send = db::index{*events, desc::events__node_send.name};
+
+	// Any txn rewriting, redacting or purging events makes their entries in
+	// the decoded event cache stale once it has been committed, whichever
+	// unit committed it.
+	events->on_commit.emplace_back([](const db::txn &txn)
+	{
+		event::fetch::cache::clear(txn);
+	});
 }
 
 /// Shuts down the m::dbs subsystem; closes the events database. The extern
@@ -165,6 +185,7 @@ ircd::m::dbs::init::~init()
 noexcept
 {
 	// Unref DB (should close)
+	event::fetch::cache::clear();
 	events = {};
 }
 
@@ -1347,6 +1368,27 @@ ircd::m::dbs::desc::events__event_json__bloom__bits
 	{ "default",  9L                                         },
 };
 
+decltype(ircd::m::dbs::desc::events__event_json__compression)
+ircd::m::dbs::desc::events__event_json__compression
+{
+	{ "name",     "ircd.m.dbs.events._event_json.compression" },
+	{ "default",  "kZSTD;kLZ4Compression;kSnappyCompression"  },
+};
+
+decltype(ircd::m::dbs::desc::events__event_json__compression__dict__size)
+ircd::m::dbs::desc::events__event_json__compression__dict__size
+{
+	{ "name",     "ircd.m.dbs.events._event_json.compression.dict.size" },
+	{ "default",  long(16_KiB)                                          },
+};
+
+decltype(ircd::m::dbs::desc::events__event_json__compression__train__size)
+ircd::m::dbs::desc::events__event_json__compression__train__size
+{
+	{ "name",     "ircd.m.dbs.events._event_json.compression.train.size" },
+	{ "default",  long(1_MiB)                                            },
+};
+
 const ircd::db::descriptor
 ircd::m::dbs::desc::events__event_json
 {
@@ -1394,6 +1436,18 @@ ircd::m::dbs::desc::events__event_json
 
 	// meta_block size
 	size_t(events__event_json__meta_block__size),
+
+	// compression
+	string_view{events__event_json__compression},
+
+	// compactor
+	{},
+
+	// compression dictionary size
+	size_t(events__event_json__compression__dict__size),
+
+	// compression dictionary training sample size
+	size_t(events__event_json__compression__train__size),
 };
 
 //
@@ -2771,8 +2825,9 @@ ircd::m::dbs::desc::events__state_node
 	// explanation
 	R"(Node data in the m::state b-tree.
 
-	The key is the node_id (a hash of the node's value). The value is JSON.
-	See the m::state system for more information.
+	The key is the node_id (a hash of the node's value). The value is the
+	binary node format, or JSON for nodes written by older versions. See the
+	m::state system for more information.
 
 	)",
 
@@ -2810,6 +2865,316 @@ ircd::m::dbs::desc::events__state_node
 
 	// meta_block size
 	size_t(events__state_node__meta_block__size),
+
+	// compression
+	"kLZ4Compression;kSnappyCompression",
+
+	// compactor
+	{
+		state::gc::filter
+	},
+};
+
+//
+// room sync
+//
+
+decltype(ircd::m::dbs::desc::events__room_sync__block__size)
+ircd::m::dbs::desc::events__room_sync__block__size
+{
+	{ "name",     "ircd.m.dbs.events._room_sync.block.size" },
+	{ "default",  4096L                                     },
+};
+
+decltype(ircd::m::dbs::desc::events__room_sync__meta_block__size)
+ircd::m::dbs::desc::events__room_sync__meta_block__size
+{
+	{ "name",     "ircd.m.dbs.events._room_sync.meta_block.size" },
+	{ "default",  8192L                                          },
+};
+
+decltype(ircd::m::dbs::desc::events__room_sync__cache__size)
+ircd::m::dbs::desc::events__room_sync__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs.events._room_sync.cache.size"  },
+		{ "default",  long(32_MiB)                               },
+	}, []
+	{
+		const size_t &value{events__room_sync__cache__size};
+		db::capacity(db::cache(room_sync), value);
+	}
+};
+
+decltype(ircd::m::dbs::desc::events__room_sync__cache_comp__size)
+ircd::m::dbs::desc::events__room_sync__cache_comp__size
+{
+	{
+		{ "name",     "ircd.m.dbs.events._room_sync.cache_comp.size"  },
+		{ "default",  long(16_MiB)                                    },
+	}, []
+	{
+		const size_t &value{events__room_sync__cache_comp__size};
+		db::capacity(db::cache_compressed(room_sync), value);
+	}
+};
+
+/// prefix transform for type,state_key in room_id; identical in form to
+/// the _room_state transform.
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::events__room_sync__pfx
+{
+	"_room_sync",
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, "\0"_sv).first;
+	}
+};
+
+/// Value of a fragment entry in room_sync: the event_idx the fragment was
+/// rendered from followed by the fragment JSON.
+ircd::string_view
+ircd::m::dbs::room_sync_val(const mutable_buffer &out_,
+                            const event::idx &event_idx,
+                            const string_view &fragment)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, byte_view<string_view>(event_idx)));
+	consume(out, copy(out, fragment));
+	return { data(out_), data(out) };
+}
+
+std::tuple<ircd::m::event::idx, ircd::json::object>
+ircd::m::dbs::room_sync_val(const string_view &amalgam)
+{
+	if(unlikely(size(amalgam) < sizeof(event::idx)))
+		return { 0UL, json::object{} };
+
+	const byte_view<event::idx> event_idx
+	{
+		amalgam.substr(0, sizeof(event::idx))
+	};
+
+	return
+	{
+		event_idx, json::object
+		{
+			amalgam.substr(sizeof(event::idx))
+		}
+	};
+}
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::events__room_sync
+{
+	// name
+	"_room_sync",
+
+	// explanation
+	R"(Pre-rendered present state of the room for /sync.
+
+	[room_id | type + state_key] => event_idx + json
+	[room_id] => event_idx
+
+	This column is a snapshot of the present state table with each event
+	already rendered for clients, including its prev_content. A fragment is
+	only valid while its event_idx matches the room_state entry for the same
+	key; otherwise it is rendered again. The entry keyed by the room_id alone
+	is the snapshot head: the greatest event_idx folded into the snapshot.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	events__room_sync__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(events_cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	bool(events_cache_comp_enable)? -1 : 0,
+
+	// bloom filter bits
+	0,
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(events__room_sync__block__size),
+
+	// meta_block size
+	size_t(events__room_sync__meta_block__size),
+};
+
+//
+// node send
+//
+
+decltype(ircd::m::dbs::desc::events__node_send__block__size)
+ircd::m::dbs::desc::events__node_send__block__size
+{
+	{ "name",     "ircd.m.dbs.events._node_send.block.size" },
+	{ "default",  512L                                      },
+};
+
+decltype(ircd::m::dbs::desc::events__node_send__meta_block__size)
+ircd::m::dbs::desc::events__node_send__meta_block__size
+{
+	{ "name",     "ircd.m.dbs.events._node_send.meta_block.size" },
+	{ "default",  4096L                                          },
+};
+
+decltype(ircd::m::dbs::desc::events__node_send__cache__size)
+ircd::m::dbs::desc::events__node_send__cache__size
+{
+	{
+		{ "name",     "ircd.m.dbs.events._node_send.cache.size"  },
+		{ "default",  long(4_MiB)                                },
+	}, []
+	{
+		const size_t &value{events__node_send__cache__size};
+		db::capacity(db::cache(node_send), value);
+	}
+};
+
+/// prefix transform for event_idx in origin
+const ircd::db::prefix_transform
+ircd::m::dbs::desc::events__node_send__pfx
+{
+	"_node_send",
+	[](const string_view &key)
+	{
+		return has(key, "\0"_sv);
+	},
+
+	[](const string_view &key)
+	{
+		return split(key, "\0"_sv).first;
+	}
+};
+
+/// The event_idx is written big-endian so the default comparator sorts each
+/// origin's queue in the order events were admitted.
+ircd::string_view
+ircd::m::dbs::node_send_key(const mutable_buffer &out_,
+                            const string_view &origin,
+                            const event::idx &event_idx)
+{
+	assert(size(out_) >= NODE_SEND_KEY_MAX_SIZE);
+	const event::idx event_idx_be
+	{
+		hton(event_idx)
+	};
+
+	mutable_buffer out{out_};
+	consume(out, copy(out, origin));
+	consume(out, copy(out, "\0"_sv));
+	consume(out, copy(out, byte_view<string_view>(event_idx_be)));
+	return { data(out_), data(out) };
+}
+
+ircd::string_view
+ircd::m::dbs::node_send_key(const mutable_buffer &out_,
+                            const string_view &origin)
+{
+	mutable_buffer out{out_};
+	consume(out, copy(out, origin));
+	consume(out, copy(out, "\0"_sv));
+	return { data(out_), data(out) };
+}
+
+ircd::m::event::idx
+ircd::m::dbs::node_send_key(const string_view &amalgam)
+{
+	const auto &key
+	{
+		amalgam.substr(amalgam.find("\0"_sv) + 1)
+	};
+
+	if(unlikely(size(key) < sizeof(event::idx)))
+		return 0UL;
+
+	const byte_view<event::idx> event_idx_be
+	{
+		key.substr(0, sizeof(event::idx))
+	};
+
+	return ntoh(event::idx(event_idx_be));
+}
+
+const ircd::db::descriptor
+ircd::m::dbs::desc::events__node_send
+{
+	// name
+	"_node_send",
+
+	// explanation
+	R"(Outbound federation queue for each remote server.
+
+	[origin | event_idx] => --
+	[] => event_idx
+
+	Each entry is a reference to a PDU of ours which has not yet been accepted
+	by the remote server. Transactions are assembled from the front of the
+	queue and its entries are deleted when a transaction succeeds. The entry
+	with an empty origin is the fan-out cursor: the greatest event_idx which
+	has been entered into the queues of all servers in its room.
+
+	)",
+
+	// typing (key, value)
+	{
+		typeid(string_view), typeid(string_view)
+	},
+
+	// options
+	{},
+
+	// comparator
+	{},
+
+	// prefix transform
+	events__node_send__pfx,
+
+	// drop column
+	false,
+
+	// cache size
+	bool(events_cache_enable)? -1 : 0,
+
+	// cache size for compressed assets
+	0,
+
+	// bloom filter bits
+	0,
+
+	// expect queries hit
+	false,
+
+	// block size
+	size_t(events__node_send__block__size),
+
+	// meta_block size
+	size_t(events__node_send__meta_block__size),
 };
 
 //
@@ -3073,6 +3438,27 @@ ircd::m::dbs::desc::events__content__cache_comp__size
 	}
 };
 
+decltype(ircd::m::dbs::desc::events__content__compression)
+ircd::m::dbs::desc::events__content__compression
+{
+	{ "name",     "ircd.m.dbs.events.content.compression"    },
+	{ "default",  "kZSTD;kLZ4Compression;kSnappyCompression" },
+};
+
+decltype(ircd::m::dbs::desc::events__content__compression__dict__size)
+ircd::m::dbs::desc::events__content__compression__dict__size
+{
+	{ "name",     "ircd.m.dbs.events.content.compression.dict.size" },
+	{ "default",  long(16_KiB)                                      },
+};
+
+decltype(ircd::m::dbs::desc::events__content__compression__train__size)
+ircd::m::dbs::desc::events__content__compression__train__size
+{
+	{ "name",     "ircd.m.dbs.events.content.compression.train.size" },
+	{ "default",  long(1_MiB)                                        },
+};
+
 const ircd::db::descriptor
 ircd::m::dbs::desc::events_content
 {
@@ -3127,6 +3513,18 @@ ircd::m::dbs::desc::events_content
 
 	// meta_block size
 	size_t(events__content__meta_block__size),
+
+	// compression
+	string_view{events__content__compression},
+
+	// compactor
+	{},
+
+	// compression dictionary size
+	size_t(events__content__compression__dict__size),
+
+	// compression dictionary training sample size
+	size_t(events__content__compression__train__size),
 };
 
 //
@@ -4165,6 +4563,14 @@ ircd::m::dbs::desc::events
 	// Mapping of all current head events for a room.
 	events__room_head,
 
+	// (room_id, (type, state_key)) => (event_idx, json)
+	// Pre-rendered PRESENT STATE of the room for /sync.
+	events__room_sync,
+
+	// (origin, event_idx) => ()
+	// Outbound federation queue for each remote server.
+	events__node_send,
+
 	//
 	// These columns are legacy; they have been dropped from the schema.
 	//
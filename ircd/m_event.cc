@@ -520,6 +520,40 @@ ircd::m::prefetch(const event::idx &event_idx,
 	db::prefetch(column, byte_view<string_view>{event_idx});
 }
 
+/// Submits the event to the readahead window; the query mirrors the one
+/// event::fetch will make with these opts (event_json or the row columns).
+/// Returns false when the window is full.
+bool
+ircd::m::prefetch(db::prefetcher &prefetcher,
+                  const event::idx &event_idx,
+                  const event::fetch::opts &opts)
+{
+	if(prefetcher.full())
+		return false;
+
+	const string_view &key
+	{
+		byte_view<string_view>(event_idx)
+	};
+
+	if(event::fetch::should_seek_json(opts))
+		return prefetcher(dbs::event_json, key, opts.gopts);
+
+	bool ret{false};
+	for(size_t i(0); i < opts.keys.size(); ++i)
+		if(opts.keys.test(i))
+			ret |= prefetcher(dbs::event_column.at(i), key, opts.gopts);
+
+	return ret;
+}
+
+bool
+ircd::m::consume(db::prefetcher &prefetcher,
+                 const event::idx &event_idx)
+{
+	return prefetcher.consume(byte_view<string_view>(event_idx));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // event/cached.h
@@ -905,6 +939,9 @@ ircd::m::seek(event::fetch &fetch,
 
 	assert(fetch.fopts);
 	const auto &opts(*fetch.fopts);
+	if((fetch.cached = event::fetch::cache::get(event_idx)))
+		return (fetch.valid = fetch.assign_from_cache());
+
 	if(!fetch.should_seek_json(opts))
 		if((fetch.valid = db::seek(fetch.row, key, opts.gopts)))
 			if((fetch.valid = fetch.assign_from_row(key)))
@@ -916,6 +953,126 @@ ircd::m::seek(event::fetch &fetch,
 	return fetch.valid;
 }
 
+/// Fetches a batch of events with one coalesced database query rather than
+/// a seek per event (or per event per column for a row query). The closure
+/// is called in the order of the input for each event found; the event
+/// references data which is only valid for the duration of the call.
+/// Returns the number of events passed to the closure.
+size_t
+ircd::m::seek(const vector_view<const event::idx> &event_idx,
+              const event::fetch::each_closure &closure,
+              const event::fetch::opts &opts)
+{
+	size_t ret(0);
+	if(event::fetch::should_seek_json(opts))
+	{
+		// Events found in the cache are not queried.
+		std::vector<event::fetch::cache::handle> cached(event_idx.size());
+		std::vector<std::pair<db::column *, string_view>> ops;
+		ops.reserve(event_idx.size());
+		for(size_t i(0); i < event_idx.size(); ++i)
+			if(!(cached[i] = event::fetch::cache::get(event_idx[i])))
+				ops.emplace_back(&dbs::event_json, event::fetch::key(&event_idx[i]));
+
+		std::vector<bool> found;
+		const auto vals
+		{
+			db::read(ops, found, opts.gopts)
+		};
+
+		for(size_t i(0), j(0); i < event_idx.size(); ++i)
+		{
+			if(cached[i])
+			{
+				m::event event;
+				event::fetch::cache::assign(event, *cached[i], opts.keys);
+
+				++ret;
+				if(!closure(event_idx[i], event))
+					break;
+
+				continue;
+			}
+
+			const auto pos(j++);
+			if(!found[pos])
+				continue;
+
+			event::fetch::cache::set(event_idx[i], json::object{vals[pos]});
+			const m::event event
+			{
+				json::object{vals[pos]}, opts.keys
+			};
+
+			++ret;
+			if(!closure(event_idx[i], event))
+				break;
+		}
+
+		return ret;
+	}
+
+	// Row query; every selected key has a direct column.
+	size_t cols(0);
+	std::array<db::column *, event::size()> col;
+	for(size_t i(0); i < opts.keys.size(); ++i)
+		if(opts.keys.test(i))
+			col[cols++] = &dbs::event_column.at(i);
+
+	if(unlikely(!cols))
+		return ret;
+
+	std::vector<std::pair<db::column *, string_view>> ops(event_idx.size() * cols);
+	for(size_t i(0); i < event_idx.size(); ++i)
+		for(size_t j(0); j < cols; ++j)
+			ops[i * cols + j] = { col[j], event::fetch::key(&event_idx[i]) };
+
+	std::vector<bool> found;
+	const auto vals
+	{
+		db::read(ops, found, opts.gopts)
+	};
+
+	for(size_t i(0); i < event_idx.size(); ++i)
+	{
+		bool valid(false);
+		m::event event;
+		for(size_t j(0); j < cols; ++j)
+		{
+			const auto pos(i * cols + j);
+			const auto &descriptor
+			{
+				describe(*col[j])
+			};
+
+			const bool is_string
+			{
+				descriptor.type.second == typeid(string_view)
+			};
+
+			if(!found[pos] && is_string)
+				json::set(event, descriptor.name, string_view{});
+			else if(!found[pos])
+				json::set(event, descriptor.name, json::undefined_number);
+			else if(is_string)
+				json::set(event, descriptor.name, string_view{vals[pos]});
+			else
+				json::set(event, descriptor.name, byte_view<string_view>{vals[pos]});
+
+			valid |= found[pos];
+		}
+
+		if(!valid)
+			continue;
+
+		++ret;
+		if(!closure(event_idx[i], event))
+			break;
+	}
+
+	return ret;
+}
+
 //
 // event::fetch
 //
@@ -999,10 +1156,16 @@ ircd::m::event::fetch::fetch(const event::idx &event_idx,
 {
 	event_idx
 }
+,cached
+{
+	event_idx?
+		cache::get(event_idx):
+		cache::handle{}
+}
 ,_json
 {
 	dbs::event_json,
-	event_idx && should_seek_json(opts)?
+	event_idx && !cached && should_seek_json(opts)?
 		key(&event_idx):
 		string_view{},
 	opts.gopts
@@ -1010,10 +1173,10 @@ ircd::m::event::fetch::fetch(const event::idx &event_idx,
 ,row
 {
 	*dbs::events,
-	event_idx && !_json.valid(key(&event_idx))?
+	event_idx && !cached && !_json.valid(key(&event_idx))?
 		key(&event_idx):
 		string_view{},
-	event_idx && !_json.valid(key(&event_idx))?
+	event_idx && !cached && !_json.valid(key(&event_idx))?
 		event::keys{opts.keys}:
 		event::keys{event::keys::include{}},
 	cell,
@@ -1021,6 +1184,8 @@ ircd::m::event::fetch::fetch(const event::idx &event_idx,
 }
 ,valid
 {
+	cached?
+		assign_from_cache():
 	event_idx && _json.valid(key(&event_idx))?
 		assign_from_json(key(&event_idx)):
 		assign_from_row(key(&event_idx))
@@ -1079,6 +1244,21 @@ ircd::m::event::fetch::assign_from_json(const string_view &key)
 
 	assert(!empty(source));
 	assert(data(event.source) == data(source));
+	cached = cache::set(event_idx, source);
+	return true;
+}
+
+bool
+ircd::m::event::fetch::assign_from_cache()
+{
+	auto &event
+	{
+		static_cast<m::event &>(*this)
+	};
+
+	assert(cached);
+	assert(fopts);
+	cache::assign(event, *cached, fopts->keys);
 	return true;
 }
 
@@ -1144,6 +1324,236 @@ ircd::m::event::fetch::opts::opts(const event::keys::selection &keys,
 {
 }
 
+//
+// event::fetch::cache
+//
+
+decltype(ircd::m::event::fetch::cache::bytes)
+ircd::m::event::fetch::cache::bytes;
+
+decltype(ircd::m::event::fetch::cache::lru)
+ircd::m::event::fetch::cache::lru;
+
+decltype(ircd::m::event::fetch::cache::map)
+ircd::m::event::fetch::cache::map;
+
+/// Memory held for an entry in addition to its JSON: the string and the
+/// tuple sharing one allocation with the control block of the handle, the
+/// node of the LRU list, and the node and bucket of the map.
+decltype(ircd::m::event::fetch::cache::overhead)
+ircd::m::event::fetch::cache::overhead
+{
+	sizeof(std::pair<std::string, m::event>) + 2 * sizeof(long) + sizeof(void *) +
+	sizeof(decltype(lru)::value_type) + 2 * sizeof(void *) +
+	sizeof(decltype(map)::value_type) + sizeof(size_t) + 2 * sizeof(void *)
+};
+
+decltype(ircd::m::event::fetch::cache::enable)
+ircd::m::event::fetch::cache::enable
+{
+	{ "name",     "ircd.m.event.fetch.cache.enable" },
+	{ "default",  true                              },
+};
+
+decltype(ircd::m::event::fetch::cache::size)
+ircd::m::event::fetch::cache::size
+{
+	{
+		{ "name",     "ircd.m.event.fetch.cache.size" },
+		{ "default",  long(64_MiB)                    },
+	}, []
+	{
+		shrink(size_t(size));
+	}
+};
+
+decltype(ircd::m::event::fetch::cache::hits)
+ircd::m::event::fetch::cache::hits
+{
+	{ "name", "ircd.m.event.fetch.cache.hits" },
+};
+
+decltype(ircd::m::event::fetch::cache::misses)
+ircd::m::event::fetch::cache::misses
+{
+	{ "name", "ircd.m.event.fetch.cache.misses" },
+};
+
+/// Copies the decoded event into the fetch's tuple and clears the members
+/// which are not selected; the result is the same as parsing the source
+/// with the selection.
+void
+ircd::m::event::fetch::cache::assign(event &event,
+                                     const m::event &cached,
+                                     const keys::selection &selection)
+{
+	event = cached;
+	if(selection.all())
+		return;
+
+	size_t i(0);
+	json::for_each(event, [&selection, &i]
+	(const auto &key, auto &val)
+	{
+		if(!selection.test(i++))
+			val = std::decay_t<decltype(val)>{};
+	});
+}
+
+void
+ircd::m::event::fetch::cache::clear()
+{
+	map.clear();
+	lru.clear();
+	bytes = 0;
+}
+
+/// Evicts the least recently used entries until the cache is within max.
+/// Returns the number of entries evicted.
+size_t
+ircd::m::event::fetch::cache::shrink(const size_t &max)
+{
+	size_t ret(0);
+	while(bytes > max && !lru.empty())
+	{
+		const auto &back(lru.back());
+		assert(bytes >= back.second->source.size() + overhead);
+		bytes -= back.second->source.size() + overhead;
+		map.erase(back.first);
+		lru.pop_back();
+		++ret;
+	}
+
+	return ret;
+}
+
+/// Drops the entries of the events written by a transaction and of the
+/// targets of redactions in it. Called once the transaction is committed; a
+/// fetch which yields while the transaction is being built would otherwise
+/// re-enter what it read before the commit.
+size_t
+ircd::m::event::fetch::cache::clear(const db::txn &txn)
+{
+	size_t ret(0);
+	if(map.empty())
+		return ret;
+
+	const auto &event_json(db::name(dbs::event_json));
+	const auto &event_refs(db::name(dbs::event_refs));
+	db::for_each(txn, [&ret, &event_json, &event_refs]
+	(const db::delta &delta)
+	{
+		const auto &col(std::get<delta.COL>(delta));
+		const auto &key(std::get<delta.KEY>(delta));
+		if(col == event_json)
+		{
+			ret += clear(byte_view<event::idx>(key));
+			return;
+		}
+
+		if(col != event_refs || key.size() < sizeof(event::idx) * 2)
+			return;
+
+		const auto &[type, src]
+		{
+			dbs::event_refs_key(key.substr(sizeof(event::idx)))
+		};
+
+		if(type == dbs::ref::M_ROOM_REDACTION)
+			ret += clear(byte_view<event::idx>(key.substr(0, sizeof(event::idx))));
+	});
+
+	return ret;
+}
+
+bool
+ircd::m::event::fetch::cache::clear(const idx &event_idx)
+{
+	const auto it
+	{
+		map.find(event_idx)
+	};
+
+	if(it == end(map))
+		return false;
+
+	assert(bytes >= it->second->second->source.size() + overhead);
+	bytes -= it->second->second->source.size() + overhead;
+	lru.erase(it->second);
+	map.erase(it);
+	return true;
+}
+
+/// Copies and parses the event JSON into a new entry and returns the handle;
+/// if the event is already cached the existing entry is returned instead.
+/// Least recently used entries are evicted to stay within the size. Returns
+/// an empty handle if the cache is disabled or the event is too large.
+ircd::m::event::fetch::cache::handle
+ircd::m::event::fetch::cache::set(const idx &event_idx,
+                                  const json::object &source)
+{
+	const size_t max(size);
+	if(!bool(enable) || !event_idx || empty(source) || source.size() + overhead > max)
+		return {};
+
+	const auto it
+	{
+		map.find(event_idx)
+	};
+
+	if(it != end(map))
+	{
+		lru.splice(begin(lru), lru, it->second);
+		return it->second->second;
+	}
+
+	// The event views the string held in the same allocation; the handle
+	// aliases the event.
+	auto entry
+	{
+		std::make_shared<std::pair<std::string, m::event>>(std::string{source}, m::event{})
+	};
+
+	entry->second = m::event
+	{
+		json::object{entry->first}
+	};
+
+	const handle ret
+	{
+		entry, &entry->second
+	};
+
+	lru.emplace_front(event_idx, ret);
+	map.emplace(event_idx, begin(lru));
+	bytes += source.size() + overhead;
+	shrink(max);
+	return ret;
+}
+
+/// Returns the handle to the event or empty if it is not cached.
+ircd::m::event::fetch::cache::handle
+ircd::m::event::fetch::cache::get(const idx &event_idx)
+{
+	if(!bool(enable))
+		return {};
+
+	const auto it
+	{
+		map.find(event_idx)
+	};
+
+	if(it == end(map))
+	{
+		misses += 1;
+		return {};
+	}
+
+	lru.splice(begin(lru), lru, it->second);
+	hits += 1;
+	return it->second->second;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // event/event_id.h
@@ -2157,6 +2567,162 @@ ircd::m::event::sign(const string_view &event,
 
 	return sig;
 }
+
+/// Batch verification of PDUs. The key lookups (which may yield) and the
+/// essential reductions are performed on this thread; the hashing and
+/// ed25519 checks are fanned out to the ctx::ole threads. The result for
+/// each PDU is written to the mask at the same index; a PDU passes if any
+/// key from its origin verifies and, when `hash` is true, its content hash
+/// matches. Returns the number of PDUs which passed.
+size_t
+ircd::m::verify(const vector_view<const json::object> &pdus,
+                const vector_view<bool> &mask,
+                const bool &hash)
+{
+	struct pdu
+	{
+		m::event event;
+		m::event essential;
+		std::vector<std::pair<ed25519::pk, ed25519::sig>> keys;
+	};
+
+	const size_t count
+	{
+		std::min(pdus.size(), mask.size())
+	};
+
+	std::vector<pdu> batch(count);
+	size_t bufsz(0), i(0);
+	for(; i < count; ++i)
+	{
+		batch[i].event = pdus[i];
+		bufsz += size(string_view{json::get<"content"_>(batch[i].event)});
+	}
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		bufsz
+	};
+
+	mutable_buffer contentbuf{buf};
+	for(i = 0; i < count; ++i)
+	{
+		auto &pdu(batch[i]);
+		mask[i] = false;
+		try
+		{
+			const string_view &origin
+			{
+				at<"origin"_>(pdu.event)
+			};
+
+			const json::object &origin_sigs
+			{
+				at<"signatures"_>(pdu.event).at(origin)
+			};
+
+			const m::node::id::buf node_id
+			{
+				m::node::id::origin, origin
+			};
+
+			const m::node node
+			{
+				node_id
+			};
+
+			for(const auto &p : origin_sigs) try
+			{
+				node.key(unquote(p.first), [&pdu, &p]
+				(const ed25519::pk &pk)
+				{
+					pdu.keys.emplace_back(pk, ed25519::sig{[&p](auto &buf)
+					{
+						b64decode(buf, unquote(p.second));
+					}});
+				});
+			}
+			catch(const m::NOT_FOUND &e)
+			{
+				log::derror
+				{
+					"Failed to verify %s because key %s for %s :%s",
+					string_view{json::get<"event_id"_>(pdu.event)},
+					unquote(p.first),
+					origin,
+					e.what()
+				};
+			}
+
+			const size_t contentsz
+			{
+				size(string_view{json::get<"content"_>(pdu.event)})
+			};
+
+			pdu.essential = essential(pdu.event, mutable_buffer{data(contentbuf), contentsz});
+			consume(contentbuf, contentsz);
+		}
+		catch(const ctx::interrupted &)
+		{
+			throw;
+		}
+		catch(const std::exception &e)
+		{
+			pdu.keys.clear();
+			log::derror
+			{
+				"Failed to verify %s :%s",
+				string_view{json::get<"event_id"_>(pdu.event)},
+				e.what()
+			};
+		}
+	}
+
+	// Partition the batch into a few closures per offload thread so the
+	// completion overhead on this thread doesn't scale with the PDU count.
+	const size_t chunks
+	{
+		std::clamp(size_t(ctx::ole::thread_max) * 4, 1UL, std::max(count, 1UL))
+	};
+
+	const size_t chunksz
+	{
+		(count + chunks - 1) / chunks
+	};
+
+	std::vector<ctx::ole::closure> funcs;
+	funcs.reserve(chunks);
+	for(size_t c(0); c < count; c += chunksz)
+		funcs.emplace_back([&batch, &mask, &hash, c, e(std::min(c + chunksz, count))]
+		{
+			thread_local char preimage_buf[event::MAX_SIZE];
+			for(size_t i(c); i < e; ++i)
+			{
+				const auto &pdu(batch[i]);
+				if(pdu.keys.empty())
+					continue;
+
+				if(hash && !verify_hash(pdu.event))
+					continue;
+
+				const string_view preimage
+				{
+					stringify(preimage_buf, pdu.essential)
+				};
+
+				for(const auto &[pk, sig] : pdu.keys)
+					if(pk.verify(preimage, sig))
+					{
+						mask[i] = true;
+						break;
+					}
+			}
+		});
+
+	ctx::ole::offload(funcs);
+	return std::count(begin(mask), begin(mask) + count, true);
+}
+
 bool
 ircd::m::verify(const event &event)
 {
@@ -726,6 +726,13 @@ const
 // room::messages
 //
 
+decltype(ircd::m::room::messages::prefetch_window)
+ircd::m::room::messages::prefetch_window
+{
+	{ "name",     "ircd.m.room.messages.prefetch.window" },
+	{ "default",  16L                                    },
+};
+
 ircd::m::room::messages::messages(const m::room &room,
                                   const event::fetch::opts *const &fopts)
 :room{room}
@@ -737,6 +744,10 @@ ircd::m::room::messages::messages(const m::room &room,
 		*room.fopts:
 		event::fetch::default_opts
 }
+,_prefetch
+{
+	size_t(prefetch_window)
+}
 {
 	if(room.event_id)
 		seek(room.event_id);
@@ -756,6 +767,10 @@ ircd::m::room::messages::messages(const m::room &room,
 		*room.fopts:
 		event::fetch::default_opts
 }
+,_prefetch
+{
+	size_t(prefetch_window)
+}
 {
 	seek(event_id);
 }
@@ -772,6 +787,10 @@ ircd::m::room::messages::messages(const m::room &room,
 		*room.fopts:
 		event::fetch::default_opts
 }
+,_prefetch
+{
+	size_t(prefetch_window)
+}
 {
 	// As a special convenience for the ctor only, if the depth=0 and
 	// nothing is found another attempt is made for depth=1 for synapse
@@ -811,6 +830,8 @@ ircd::m::room::messages::seek(const uint64_t &depth)
 	};
 
 	this->it = dbs::room_events.begin(seek_key);
+	this->_ra = db::index::const_iterator{};
+	this->_prefetch.clear();
 	return bool(*this);
 }
 
@@ -832,6 +853,8 @@ try
 	};
 
 	this->it = dbs::room_events.begin(seek_key);
+	this->_ra = db::index::const_iterator{};
+	this->_prefetch.clear();
 	if(!bool(*this))
 		return false;
 
@@ -897,6 +920,7 @@ const
 const ircd::m::event &
 ircd::m::room::messages::fetch()
 {
+	readahead();
 	m::seek(_event, event_idx());
 	return _event;
 }
@@ -904,10 +928,59 @@ ircd::m::room::messages::fetch()
 const ircd::m::event &
 ircd::m::room::messages::fetch(std::nothrow_t)
 {
+	readahead();
 	m::seek(_event, event_idx(), std::nothrow);
 	return _event;
 }
 
+/// Accounts the event at the cursor against the window and refills the
+/// window ahead of it in the direction the cursor last moved. The readahead
+/// iterator is (re)positioned at the cursor whenever the window runs dry,
+/// which covers the first fetch and the cursor having moved past everything
+/// which was prefetched, and when the cursor reverses; the window behind it
+/// is then discarded.
+void
+ircd::m::room::messages::readahead()
+{
+	if(!_prefetch.window)
+		return;
+
+	assert(bool(*this));
+	consume(_prefetch, event_idx());
+	if(_ra_back != _back)
+		_prefetch.clear();
+
+	const auto advance{[this]
+	{
+		// Toward older events is ++ on the index; see operator--().
+		if(_ra_back)
+			++_ra;
+		else
+			--_ra;
+	}};
+
+	if(_prefetch.empty())
+	{
+		char buf[dbs::ROOM_EVENTS_KEY_MAX_SIZE];
+		_ra = dbs::room_events.begin(dbs::room_events_key(buf, room.room_id, depth(), event_idx()));
+		_ra_back = _back;
+		if(bool(_ra))
+			advance();
+	}
+
+	assert(_event.fopts);
+	for(; bool(_ra) && !_prefetch.full(); advance())
+	{
+		const auto part
+		{
+			dbs::room_events_key(_ra->first)
+		};
+
+		if(!m::prefetch(_prefetch, std::get<1>(part), *_event.fopts))
+			break;
+	}
+}
+
 //
 // room::state
 //
@@ -1215,20 +1288,46 @@ bool
 ircd::m::room::state::for_each(const event::closure_bool &closure)
 const
 {
-	event::fetch event
+	const auto &opts
 	{
 		fopts? *fopts : event::fetch::default_opts
 	};
 
-	return for_each(event::closure_idx_bool{[&event, &closure]
-	(const event::idx &event_idx)
+	// The state indexes are gathered into batches which are each fetched
+	// with a single database query.
+	//TODO: conf
+	size_t count(0);
+	std::array<event::idx, 64> batch;
+	const auto flush{[&opts, &closure, &batch, &count]
 	{
-		if(seek(event, event_idx, std::nothrow))
-			if(!closure(event))
-				return false;
+		bool ret{true};
+		const vector_view<const event::idx> idxs
+		(
+			batch.data(), count
+		);
+
+		count = 0;
+		m::seek(idxs, [&ret, &closure]
+		(const event::idx &event_idx, const m::event &event)
+		{
+			ret = closure(event);
+			return ret;
+		}, opts);
 
-		return true;
-	}});
+		return ret;
+	}};
+
+	const bool ret
+	{
+		for_each(event::closure_idx_bool{[&batch, &count, &flush]
+		(const event::idx &event_idx)
+		{
+			batch.at(count++) = event_idx;
+			return count < batch.size() || flush();
+		}})
+	};
+
+	return ret && (!count || flush());
 }
 
 void
@@ -81,7 +81,25 @@ ircd::m::state::get(std::nothrow_t,
 	bool ret{false};
 	char nextbuf[ID_MAX_SZ];
 	string_view nextid{root};
-	const auto node_closure{[&ret, &nextbuf, &nextid, &key, &closure]
+	const auto binary_closure{[&ret, &nextbuf, &nextid, &key, &closure]
+	(const node::bin &node)
+	{
+		const auto pos(node.find(key));
+		if(pos < node.keys() && keycmp(node.key(pos), key) == 0)
+		{
+			ret = true;
+			nextid = {};
+			closure(node.val(pos));
+			return;
+		}
+
+		if(pos < node.slots() && !empty(node.child(pos)))
+			nextid = { nextbuf, strlcpy(nextbuf, node.child(pos)) };
+		else
+			nextid = {};
+	}};
+
+	const auto legacy_closure{[&ret, &nextbuf, &nextid, &key, &closure]
 	(const node &node)
 	{
 		auto pos(node.find(key));
@@ -103,6 +121,15 @@ ircd::m::state::get(std::nothrow_t,
 			nextid = {};
 	}};
 
+	const auto node_closure{[&binary_closure, &legacy_closure]
+	(const string_view &buf)
+	{
+		if(node::bin::test(buf))
+			binary_closure(node::bin{buf});
+		else
+			legacy_closure(node{json::object{buf}});
+	}};
+
 	while(nextid)
 		if(!get_node(std::nothrow, nextid, node_closure))
 			return false;
@@ -199,7 +226,7 @@ ircd::m::state::for_each(const string_view &root,
 
 namespace ircd::m::state
 {
-	size_t _count_recurse(const node &, const json::array &key, const json::array &dom);
+	size_t _count_recurse(const string_view &node, const json::array &key, const json::array &dom);
 	size_t _count(const string_view &root, const json::array &key);
 }
 
@@ -240,7 +267,7 @@ ircd::m::state::_count(const string_view &root,
 }
 
 size_t
-ircd::m::state::_count_recurse(const node &node,
+ircd::m::state::_count_recurse(const string_view &node,
                                const json::array &key,
                                const json::array &dom)
 {
@@ -279,7 +306,7 @@ ircd::m::state::_count_recurse(const node &node,
 
 namespace ircd::m::state
 {
-	bool _dfs_recurse(const search_closure &, const node &, const json::array &key, int &);
+	bool _dfs_recurse(const search_closure &, const string_view &node, const json::array &key, int &);
 }
 
 bool
@@ -307,7 +334,7 @@ ircd::m::state::dfs(const string_view &root,
 
 bool
 ircd::m::state::_dfs_recurse(const search_closure &closure,
-                             const node &node,
+                             const string_view &node,
                              const json::array &key,
                              int &depth)
 {
@@ -351,14 +378,14 @@ namespace ircd::m::state
 {
 	static mutable_buffer _getbuffer(const uint8_t &height);
 
-	static string_view _remove(int8_t &height, db::txn &, const json::array &key, const node &node, const mutable_buffer &idbuf, node::rep &push);
+	static string_view _remove(int8_t &height, db::txn &, const json::array &key, const string_view &node, const mutable_buffer &idbuf, node::rep &push);
 
 	static string_view _insert_overwrite(db::txn &, const json::array &key, const string_view &val, const mutable_buffer &idbuf, node::rep &, const size_t &pos);
 	static string_view _insert_leaf_nonfull(db::txn &, const json::array &key, const string_view &val, const mutable_buffer &idbuf, node::rep &, const size_t &pos);
-	static json::object _insert_leaf_full(const int8_t &height, db::txn &, const json::array &key, const string_view &val, node::rep &, const size_t &pos, node::rep &push);
+	static string_view _insert_leaf_full(const int8_t &height, db::txn &, const json::array &key, const string_view &val, node::rep &, const size_t &pos, node::rep &push);
 	static string_view _insert_branch_nonfull(db::txn &, const mutable_buffer &idbuf, node::rep &, const size_t &pos, node::rep &pushed);
-	static json::object _insert_branch_full(const int8_t &height, db::txn &, node::rep &, const size_t &pos, node::rep &push, const node::rep &pushed);
-	static string_view _insert(int8_t &height, db::txn &, const json::array &key, const string_view &val, const node &node, const mutable_buffer &idbuf, node::rep &push);
+	static string_view _insert_branch_full(const int8_t &height, db::txn &, node::rep &, const size_t &pos, node::rep &push, const node::rep &pushed);
+	static string_view _insert(int8_t &height, db::txn &, const json::array &key, const string_view &val, const string_view &node, const mutable_buffer &idbuf, node::rep &push);
 
 	static string_view _create(db::txn &, const mutable_buffer &root, const string_view &type, const string_view &state_key, const string_view &val);
 }
@@ -436,7 +463,7 @@ ircd::m::state::insert(db::txn &txn,
 	node::rep push;
 	int8_t height{0};
 	string_view root{rootin};
-	get_node(root, [&](const node &node)
+	get_node(root, [&](const string_view &node)
 	{
 		root = _insert(height, txn, key, event_id, node, rootout, push);
 	});
@@ -452,7 +479,7 @@ ircd::m::state::_insert(int8_t &height,
                         db::txn &txn,
                         const json::array &key,
                         const string_view &val,
-                        const node &node,
+                        const string_view &node,
                         const mutable_buffer &idbuf,
                         node::rep &push)
 {
@@ -466,22 +493,21 @@ ircd::m::state::_insert(int8_t &height,
 
 	// This function assumes that any node argument is a previously "existing"
 	// node which means it contains at least one key/value.
-	assert(node.keys() > 0);
-	assert(node.keys() == node.vals());
-
 	node::rep rep{node};
-	const auto pos{node.find(key)};
+	assert(rep.kn > 0);
+	assert(rep.kn == rep.vn);
 
-	if(keycmp(node.key(pos), key) == 0)
+	const auto pos{rep.find(key)};
+	if(pos < rep.kn && keycmp(rep.keys[pos], key) == 0)
 		return _insert_overwrite(txn, key, val, idbuf, rep, pos);
 
-	if(node.childs() == 0 && rep.full())
+	if(rep.childs() == 0 && rep.full())
 		return _insert_leaf_full(height, txn, key, val, rep, pos, push);
 
-	if(node.childs() == 0 && !rep.full())
+	if(rep.childs() == 0 && !rep.full())
 		return _insert_leaf_nonfull(txn, key, val, idbuf, rep, pos);
 
-	if(empty(node.child(pos)))
+	if(empty(rep.chld[pos]))
 		return _insert_leaf_nonfull(txn, key, val, idbuf, rep, pos);
 
 	// These collect data from the next level.
@@ -489,7 +515,7 @@ ircd::m::state::_insert(int8_t &height,
 	string_view child;
 
 	// Recurse
-	get_node(node.child(pos), [&](const auto &node)
+	get_node(rep.chld[pos], [&](const auto &node)
 	{
 		child = _insert(height, txn, key, val, node, idbuf, pushed);
 	});
@@ -508,7 +534,7 @@ ircd::m::state::_insert(int8_t &height,
 	return rep.write(txn, idbuf);
 }
 
-ircd::json::object
+ircd::string_view
 ircd::m::state::_insert_branch_full(const int8_t &height,
                                     db::txn &txn,
                                     node::rep &rep,
@@ -570,11 +596,11 @@ ircd::m::state::_insert_branch_full(const int8_t &height,
 	};
 
 	// Courtesy reassignment of all the references in `push` after rewrite.
-	push = state::node{ret};
+	push = node::rep{node::bin{ret}};
 	return ret;
 }
 
-ircd::json::object
+ircd::string_view
 ircd::m::state::_insert_leaf_full(const int8_t &height,
                                   db::txn &txn,
                                   const json::array &key,
@@ -625,7 +651,7 @@ ircd::m::state::_insert_leaf_full(const int8_t &height,
 	};
 
 	// Courtesy reassignment of all the references in `push` after rewrite.
-	push = state::node{ret};
+	push = node::rep{node::bin{ret}};
 	return ret;
 }
 
@@ -731,7 +757,7 @@ ircd::m::state::remove(db::txn &txn,
 	node::rep push;
 	int8_t height{0};
 	string_view root{rootin};
-	get_node(root, [&](const node &node)
+	get_node(root, [&](const string_view &node)
 	{
 		root = _remove(height, txn, key, node, rootout, push);
 	});
@@ -746,7 +772,7 @@ ircd::m::state::id
 ircd::m::state::_remove(int8_t &height,
                         db::txn &txn,
                         const json::array &key,
-                        const node &node,
+                        const string_view &node,
                         const mutable_buffer &idbuf,
                         node::rep &push)
 {
@@ -758,9 +784,9 @@ ircd::m::state::_remove(int8_t &height,
 		};
 
 	node::rep rep{node};
-	const auto pos{node.find(key)};
+	const auto pos{rep.find(key)};
 
-	if(keycmp(node.key(pos), key) == 0)
+	if(pos < rep.kn && keycmp(rep.keys[pos], key) == 0)
 	{
 
 		return {};
@@ -771,7 +797,7 @@ ircd::m::state::_remove(int8_t &height,
 	string_view child;
 
 	// Recurse
-	get_node(node.child(pos), [&](const auto &node)
+	get_node(rep.chld[pos], [&](const auto &node)
 	{
 
 		child = _remove(height, txn, key, node, idbuf, pushed);
@@ -825,7 +851,7 @@ ircd::m::state::get_node(const std::nothrow_t,
 ircd::m::state::id
 ircd::m::state::set_node(db::txn &iov,
                          const mutable_buffer &hashbuf,
-                         const json::object &node)
+                         const string_view &node)
 {
 	const sha256::buf hash
 	{
@@ -837,6 +863,11 @@ ircd::m::state::set_node(db::txn &iov,
 		b64encode_unpadded(hashbuf, hash)
 	};
 
+	// Nodes written during a collection are live even though they are not
+	// reachable from any root the collector has seen.
+	if(unlikely(gc::current))
+		gc::current->mark(hashb64);
+
 	db::txn::append
 	{
 		iov, dbs::state_node,
@@ -953,6 +984,43 @@ ircd::m::state::keycmp(const json::array &a,
 // rep
 //
 
+ircd::m::state::node::rep::rep(const string_view &node)
+:rep
+{
+	node::bin::test(node)?
+		rep{node::bin{node}}:
+		rep{state::node{json::object{node}}}
+}
+{
+}
+
+ircd::m::state::node::rep::rep(const bin &node)
+:kn{node.keys()}
+,vn{node.keys()}
+,cn{node.slots()}
+,nn{node.slots()}
+{
+	if(unlikely(kn > NODE_MAX_KEY || cn > NODE_MAX_DEG))
+		throw panic
+		{
+			"state node with %zu keys and %zu children exceeds the maximum.",
+			kn,
+			cn,
+		};
+
+	for(size_t i(0); i < kn; ++i)
+	{
+		keys[i] = node.key(i);
+		vals[i] = node.val(i);
+	}
+
+	for(size_t i(0); i < cn; ++i)
+	{
+		chld[i] = node.child(i);
+		cnts[i] = node.count(i);
+	}
+}
+
 ircd::m::state::node::rep::rep(const node &node)
 :kn{node.keys(keys.data(), keys.size())}
 ,vn{node.vals(vals.data(), vals.size())}
@@ -970,7 +1038,8 @@ ircd::m::state::node::rep::write(db::txn &txn,
 	return set_node(txn, idbuf, write(buf));
 }
 
-ircd::json::object
+/// Writes the node in the binary format (see: node::bin).
+ircd::string_view
 ircd::m::state::node::rep::write(const mutable_buffer &out)
 {
 	assert(kn == vn);
@@ -984,40 +1053,85 @@ ircd::m::state::node::rep::write(const mutable_buffer &out)
 	assert(vn <= NODE_MAX_VAL);
 	assert(cn <= NODE_MAX_DEG);
 
-	std::array<json::value, NODE_MAX_KEY> keys;
+	// Offsets are 16 bits so the node can't be any larger than this.
+	const size_t max
 	{
-		for(size_t i(0); i < kn; ++i)
-			keys[i] = this->keys[i];
-	}
+		std::min(ircd::size(out), size_t(std::numeric_limits<uint16_t>::max()))
+	};
 
-	std::array<json::value, NODE_MAX_VAL> vals;
+	const size_t on
 	{
-		for(size_t i(0); i < vn; ++i)
-			vals[i] = this->vals[i];
+		kn + vn + cn + 1
 	};
 
-	std::array<json::value, NODE_MAX_DEG> chld;
+	size_t pos
 	{
-		for(size_t i(0); i < cn; ++i)
-			chld[i] = this->chld[i];
+		sizeof(bin::head) + cn * sizeof(uint32_t) + on * sizeof(uint16_t)
 	};
 
-	std::array<json::value, NODE_MAX_DEG> cnts;
+	if(unlikely(pos > max))
+		throw panic
+		{
+			"insufficient buffer for state node header (%zu > %zu)",
+			pos,
+			max,
+		};
+
+	auto &head
 	{
-		for(size_t i(0); i < nn; ++i)
-			cnts[i] = json::value{long(this->cnts[i])};
+		*reinterpret_cast<bin::head *>(data(out))
 	};
 
-	json::iov iov;
-	const json::iov::push push[]
+	head.version = bin::FORMAT_VERSION;
+	head.flags = 0;
+	head.kn = kn;
+	head.cn = cn;
+	head.reserved = 0;
+
+	const auto cnts
+	{
+		reinterpret_cast<uint32_t *>(data(out) + sizeof(bin::head))
+	};
+
+	for(size_t i(0); i < cn; ++i)
+		cnts[i] = this->cnts[i];
+
+	const auto offs
 	{
-		{ iov, { name::key,   { keys.data(), kn } } },
-		{ iov, { name::val,   { vals.data(), vn } } },
-		{ iov, { name::child, { chld.data(), cn } } },
-		{ iov, { name::count, { cnts.data(), nn } } },
+		reinterpret_cast<uint16_t *>(cnts + cn)
 	};
 
-	return { data(out), json::print(out, iov) };
+	size_t i(0);
+	const auto append{[&out, &max, &pos, &offs, &i]
+	(const string_view &element)
+	{
+		if(unlikely(pos + ircd::size(element) > max))
+			throw panic
+			{
+				"insufficient buffer for state node data (%zu > %zu)",
+				pos + ircd::size(element),
+				max,
+			};
+
+		offs[i++] = pos;
+		pos += copy(out + pos, element);
+	}};
+
+	for(size_t j(0); j < kn; ++j)
+		append(keys[j]);
+
+	for(size_t j(0); j < vn; ++j)
+		append(vals[j]);
+
+	for(size_t j(0); j < cn; ++j)
+		append(chld[j]);
+
+	assert(i + 1 == on);
+	offs[i++] = pos;
+	return string_view
+	{
+		data(out), pos
+	};
 }
 
 /// Shift right.
@@ -1044,12 +1158,16 @@ size_t
 ircd::m::state::node::rep::find(const json::array &parts)
 const
 {
-	size_t i{0};
-	for(; i < kn; ++i)
-		if(keycmp(parts, keys[i]) <= 0)
-			return i;
+	const auto it
+	{
+		std::lower_bound(begin(keys), begin(keys) + kn, parts, []
+		(const json::array &a, const json::array &b)
+		{
+			return keycmp(a, b) < 0;
+		})
+	};
 
-	return i;
+	return std::distance(begin(keys), it);
 }
 
 size_t
@@ -1124,6 +1242,162 @@ const
 	return kn >= NODE_MAX_KEY;
 }
 
+//
+// node::bin
+//
+
+bool
+ircd::m::state::node::bin::test(const string_view &node)
+{
+	return !empty(node) && uint8_t(node[0]) == FORMAT_VERSION;
+}
+
+ircd::m::state::node::bin::bin(const string_view &node)
+:buf{node}
+{
+	assert(test(buf));
+	const auto &head
+	{
+		header()
+	};
+
+	const size_t hsz
+	{
+		sizeof(struct head) +
+		head.cn * sizeof(uint32_t) +
+		(head.kn + head.kn + head.cn + 1) * sizeof(uint16_t)
+	};
+
+	if(unlikely(ircd::size(buf) < hsz || offs()[head.kn + head.kn + head.cn] > ircd::size(buf)))
+		throw panic
+		{
+			"state node of %zu bytes is truncated or corrupt.",
+			ircd::size(buf),
+		};
+}
+
+/// Find position for a key in node; see node::find() for the semantics.
+/// The keys are sorted so this is a binary search directly on the buffer.
+size_t
+ircd::m::state::node::bin::find(const json::array &parts)
+const
+{
+	size_t lo(0), hi(keys());
+	while(lo < hi)
+	{
+		const size_t mid(lo + (hi - lo) / 2);
+		if(keycmp(parts, key(mid)) <= 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return lo;
+}
+
+size_t
+ircd::m::state::node::bin::count(const size_t &pos)
+const
+{
+	if(unlikely(pos >= slots()))
+		throw std::out_of_range
+		{
+			"state node count position out of range"
+		};
+
+	return cnts()[pos];
+}
+
+ircd::m::state::id
+ircd::m::state::node::bin::child(const size_t &pos)
+const
+{
+	if(unlikely(pos >= slots()))
+		throw std::out_of_range
+		{
+			"state node child position out of range"
+		};
+
+	return element(keys() + keys() + pos);
+}
+
+ircd::string_view
+ircd::m::state::node::bin::val(const size_t &pos)
+const
+{
+	if(unlikely(pos >= keys()))
+		throw std::out_of_range
+		{
+			"state node value position out of range"
+		};
+
+	return element(keys() + pos);
+}
+
+ircd::json::array
+ircd::m::state::node::bin::key(const size_t &pos)
+const
+{
+	if(unlikely(pos >= keys()))
+		throw std::out_of_range
+		{
+			"state node key position out of range"
+		};
+
+	return element(pos);
+}
+
+size_t
+ircd::m::state::node::bin::slots()
+const
+{
+	return header().cn;
+}
+
+size_t
+ircd::m::state::node::bin::keys()
+const
+{
+	return header().kn;
+}
+
+ircd::string_view
+ircd::m::state::node::bin::element(const size_t &i)
+const
+{
+	const auto &offs
+	{
+		this->offs()
+	};
+
+	return string_view
+	{
+		data(buf) + offs[i], data(buf) + offs[i + 1]
+	};
+}
+
+const uint16_t *
+ircd::m::state::node::bin::offs()
+const
+{
+	return reinterpret_cast<const uint16_t *>(cnts() + header().cn);
+}
+
+const uint32_t *
+ircd::m::state::node::bin::cnts()
+const
+{
+	return reinterpret_cast<const uint32_t *>(data(buf) + sizeof(struct head));
+}
+
+const ircd::m::state::node::bin::head &
+ircd::m::state::node::bin::header()
+const
+{
+	assert(ircd::size(buf) >= sizeof(struct head));
+	return *reinterpret_cast<const struct head *>(data(buf));
+}
+
 //
 // node
 //
@@ -1320,3 +1594,166 @@ const
 {
 	return json::get<name::key>(*this).count();
 }
+
+//
+// gc
+//
+
+decltype(ircd::m::state::gc::mutex)
+ircd::m::state::gc::mutex;
+
+decltype(ircd::m::state::gc::current)
+ircd::m::state::gc::current;
+
+decltype(ircd::m::state::gc::batch_min)
+ircd::m::state::gc::batch_min
+{
+	4096
+};
+
+decltype(ircd::m::state::gc::batch_div)
+ircd::m::state::gc::batch_div
+{
+	16
+};
+
+ircd::m::state::gc::gc()
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	if(unlikely(current))
+		throw panic
+		{
+			"A state node collection is already in progress."
+		};
+
+	current = this;
+}
+
+ircd::m::state::gc::~gc()
+noexcept
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	assert(current == this);
+	current = nullptr;
+}
+
+/// Called when the mark is complete. From here the compaction filter drops
+/// every node without a mark.
+void
+ircd::m::state::gc::sweep()
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	merge();
+	marks.shrink_to_fit();
+	sweeping = true;
+}
+
+bool
+ircd::m::state::gc::mark(const id &id)
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	const auto h
+	{
+		hash(id)
+	};
+
+	if(has(h))
+		return false;
+
+	batch.emplace(h);
+	if(batch.size() >= std::max(batch_min, marks.size() / batch_div))
+		merge();
+
+	return true;
+}
+
+bool
+ircd::m::state::gc::marked(const id &id)
+const
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	return has(hash(id));
+}
+
+size_t
+ircd::m::state::gc::count()
+const
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	return marks.size() + batch.size();
+}
+
+/// Merge the staged marks into the sorted vector; call with the mutex held.
+void
+ircd::m::state::gc::merge()
+{
+	const auto mid
+	{
+		marks.size()
+	};
+
+	marks.insert(end(marks), begin(batch), end(batch));
+	std::inplace_merge(begin(marks), begin(marks) + mid, end(marks));
+	batch.clear();
+}
+
+/// Call with the mutex held.
+bool
+ircd::m::state::gc::has(const uint64_t &h)
+const
+{
+	return std::binary_search(begin(marks), end(marks), h) || batch.count(h);
+}
+
+/// Compaction callback for the state_node column (see: dbs descriptor).
+/// This is called on a database env thread.
+ircd::db::op
+ircd::m::state::gc::filter(const db::compactor::args &args)
+{
+	const std::lock_guard<decltype(mutex)> lock
+	{
+		mutex
+	};
+
+	if(likely(!current || !current->sweeping))
+		return db::op::GET;
+
+	if(current->has(hash(args.key)))
+	{
+		++current->kept;
+		return db::op::GET;
+	}
+
+	++current->swept;
+	return db::op::DELETE;
+}
+
+uint64_t
+ircd::m::state::gc::hash(const id &id)
+{
+	return std::hash<string_view>{}(id);
+}
@@ -17,6 +17,21 @@ namespace ircd::net
 
 	static void init_ipv6();
 	static void wait_close_sockets();
+	static int socket_ex_index();
+}
+
+static int
+ircd_net_socket_handle_session(SSL *, SSL_SESSION *)
+noexcept;
+
+namespace ircd::net::offload
+{
+	using handler = std::function<void (const boost::system::error_code &)>;
+
+	extern bool termination;
+
+	static bool handshake(const std::shared_ptr<socket> &, const socket::handshake_type &, const handler &);
+	static void fini() noexcept;
 }
 
 void
@@ -70,15 +85,22 @@ ircd::net::init_ipv6()
 /// Network subsystem initialization
 ircd::net::init::init()
 {
+	offload::termination = false;
 	init_ipv6();
 	sslv23_client.set_verify_mode(asio::ssl::verify_peer);
 	sslv23_client.set_default_verify_paths();
+
+	// Client sessions are not cached by OpenSSL; they're handed to the
+	// callback for the cache given in the open_opts of each socket.
+	SSL_CTX_set_session_cache_mode(sslv23_client.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(sslv23_client.native_handle(), ircd_net_socket_handle_session);
 }
 
 /// Network subsystem shutdown
 ircd::net::init::~init()
 noexcept
 {
+	offload::fini();
 	wait_close_sockets();
 }
 
@@ -1286,6 +1308,38 @@ const
 namespace ircd::net
 {
 	thread_local char logheadbuf[512];
+
+	extern stats::item acceptor_handshake_full;
+	extern stats::item acceptor_handshake_resumed;
+
+	static int acceptor_ex_index();
+}
+
+/// Count of inbound handshakes which did not resume a session.
+decltype(ircd::net::acceptor_handshake_full)
+ircd::net::acceptor_handshake_full
+{
+	{ "name", "ircd.net.acceptor.handshake.full" },
+};
+
+/// Count of inbound handshakes which resumed a session from the session
+/// cache or a session ticket.
+decltype(ircd::net::acceptor_handshake_resumed)
+ircd::net::acceptor_handshake_resumed
+{
+	{ "name", "ircd.net.acceptor.handshake.resumed" },
+};
+
+/// Index of the acceptor instance in the ex_data of its SSL_CTX.
+int
+ircd::net::acceptor_ex_index()
+{
+	static const int ret
+	{
+		SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr)
+	};
+
+	return ret;
 }
 
 //
@@ -1326,6 +1380,23 @@ ircd::net::acceptor::ssl_cipher_blacklist
 	{ "default",  string_view{ircd::net::ssl_cipher_blacklist} },
 };
 
+/// Lifetime of sessions in the server-side cache and of session tickets.
+decltype(ircd::net::acceptor::ssl_session_timeout)
+ircd::net::acceptor::ssl_session_timeout
+{
+	{ "name",     "ircd.net.acceptor.ssl.session.timeout" },
+	{ "default",  7200L                                   },
+};
+
+/// Interval for rotating the session ticket key. Tickets issued under the
+/// previous key are still accepted (and replaced) for one more interval.
+decltype(ircd::net::acceptor::ssl_ticket_rotate)
+ircd::net::acceptor::ssl_ticket_rotate
+{
+	{ "name",     "ircd.net.acceptor.ssl.ticket.rotate" },
+	{ "default",  3600L                                 },
+};
+
 bool
 ircd::net::stop(acceptor &a)
 {
@@ -1667,6 +1738,9 @@ noexcept try
 
 	++handshaking;
 	sock->set_timeout(milliseconds(timeout));
+	if(offload::handshake(sock, handshake_type, handshake))
+		return;
+
 	sock->ssl.async_handshake(handshake_type, ios::handle(desc, std::move(handshake)));
 }
 catch(const ctx::interrupted &e)
@@ -1786,6 +1860,12 @@ noexcept try
 	sock->cancel_timeout();
 	assert(bool(cb));
 
+	assert(sock->ssl.native_handle());
+	if(openssl::session_reused(*sock->ssl.native_handle()))
+		acceptor_handshake_resumed += 1;
+	else
+		acceptor_handshake_full += 1;
+
 	// Toggles the behavior of non-async functions; see func comment
 	blocking(*sock, false);
 	cb(*listener_, sock);
@@ -1866,6 +1946,8 @@ ircd::net::acceptor::check_handshake_error(const error_code &ec,
 	__builtin_unreachable();
 }
 
+/// Called on the main thread or an offload thread; it only reads the SSL
+/// and the acceptor's immutable name and uses the thread-safe logger.
 bool
 ircd::net::acceptor::handle_sni(SSL &ssl,
                                 int &client_server)
@@ -1951,6 +2033,161 @@ catch(...)
 	throw;
 }
 
+static int
+ircd_net_acceptor_handle_ticket(SSL *const s,
+                                unsigned char *const name,
+                                unsigned char *const iv,
+                                EVP_CIPHER_CTX *const ctx,
+                                HMAC_CTX *const hctx,
+                                int enc)
+noexcept try
+{
+	if(unlikely(!s || !name || !iv || !ctx || !hctx))
+		throw ircd::panic
+		{
+			"Missing arguments to callback s:%p name:%p iv:%p ctx:%p hctx:%p",
+			s,
+			name,
+			iv,
+			ctx,
+			hctx
+		};
+
+	auto *const a
+	{
+		SSL_CTX_get_ex_data(SSL_get_SSL_CTX(s), ircd::net::acceptor_ex_index())
+	};
+
+	if(unlikely(!a))
+		throw ircd::panic
+		{
+			"Missing acceptor for SSL_CTX of SSL:%p", s
+		};
+
+	auto &acceptor
+	{
+		*reinterpret_cast<ircd::net::acceptor *>(a)
+	};
+
+	return acceptor.handle_ticket(*s, name, iv, *ctx, *hctx, enc);
+}
+catch(const std::exception &e)
+{
+	// Zero only foregoes the ticket; the handshake continues without it.
+	ircd::log::error
+	{
+		ircd::net::acceptor::log,
+		"Acceptor session ticket callback :%s",
+		e.what()
+	};
+
+	return 0;
+}
+catch(...)
+{
+	ircd::log::critical
+	{
+		ircd::net::acceptor::log,
+		"Acceptor session ticket callback unhandled."
+	};
+
+	throw;
+}
+
+/// Called for session tickets on the main thread and the offload threads;
+/// the keys are guarded by ticket_mutex and errors are only logged. With
+/// enc the ticket is being issued under the current key; otherwise the
+/// ticket's key name is looked up among the current and previous keys.
+int
+ircd::net::acceptor::handle_ticket(SSL &ssl,
+                                   uint8_t *const name,
+                                   uint8_t *const iv,
+                                   EVP_CIPHER_CTX &ctx,
+                                   HMAC_CTX &hctx,
+                                   const int &enc)
+{
+	static const size_t NAME_SZ {16}, HMAC_SZ {32}, AES_SZ {32};
+	static_assert(NAME_SZ + HMAC_SZ + AES_SZ == std::tuple_size<decltype(ticket_key)::value_type>());
+
+	const std::lock_guard lock
+	{
+		ticket_mutex
+	};
+
+	ticket_rotate();
+	if(enc)
+	{
+		const auto &key(ticket_key[0]);
+		if(unlikely(RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1))
+			return 0;
+
+		memcpy(name, key.data(), NAME_SZ);
+		EVP_EncryptInit_ex(&ctx, EVP_aes_256_cbc(), nullptr, key.data() + NAME_SZ + HMAC_SZ, iv);
+		HMAC_Init_ex(&hctx, key.data() + NAME_SZ, HMAC_SZ, EVP_sha256(), nullptr);
+		return 1;
+	}
+
+	for(size_t i(0); i < ticket_keys; ++i)
+	{
+		const auto &key(ticket_key[i]);
+		if(memcmp(name, key.data(), NAME_SZ) != 0)
+			continue;
+
+		HMAC_Init_ex(&hctx, key.data() + NAME_SZ, HMAC_SZ, EVP_sha256(), nullptr);
+		EVP_DecryptInit_ex(&ctx, EVP_aes_256_cbc(), nullptr, key.data() + NAME_SZ + HMAC_SZ, iv);
+
+		// A ticket under the previous key is accepted and a new one issued.
+		return i == 0? 1 : 2;
+	}
+
+	// Unknown or expired key; a full handshake is conducted.
+	return 0;
+}
+
+/// Generates a new ticket key when the interval has elapsed; the current
+/// key becomes the previous key. ticket_mutex must be held.
+void
+ircd::net::acceptor::ticket_rotate()
+{
+	const time_t now
+	{
+		ircd::time()
+	};
+
+	const seconds interval
+	{
+		ssl_ticket_rotate
+	};
+
+	const auto elapsed
+	{
+		now - ticket_key_time
+	};
+
+	if(ticket_keys && elapsed < interval.count())
+		return;
+
+	// The previous key is only kept for one interval past its replacement.
+	if(elapsed >= interval.count() * 2)
+		ticket_keys = 0;
+
+	ticket_key[1] = ticket_key[0];
+	if(unlikely(RAND_bytes(ticket_key[0].data(), ticket_key[0].size()) != 1))
+		throw error
+		{
+			"%s: Failed to generate session ticket key", string(logheadbuf, *this)
+		};
+
+	ticket_keys = std::min(ticket_keys + 1, ticket_key.size());
+	ticket_key_time = now;
+	log::debug
+	{
+		log, "%s rotated session ticket key (keys:%zu)",
+		string(logheadbuf, *this),
+		ticket_keys
+	};
+}
+
 void
 ircd::net::acceptor::configure(const json::object &opts)
 {
@@ -1982,6 +2219,9 @@ ircd::net::acceptor::configure(const json::object &opts)
 	if(opts.get<bool>("ssl_no_tlsv1_2", false))
 		flags |= ssl.no_tlsv1_2;
 
+	if(!opts.get<bool>("ssl_session_tickets", true))
+		flags |= SSL_OP_NO_TICKET;
+
 	ssl.set_options(flags);
 
 	if(!empty(unquote(opts["ssl_cipher_list"])))
@@ -2173,6 +2413,34 @@ ircd::net::acceptor::configure(const json::object &opts)
 
 	SSL_CTX_set_tlsext_servername_callback(ssl.native_handle(), ircd_net_acceptor_handle_sni);
 	SSL_CTX_set_tlsext_servername_arg(ssl.native_handle(), this);
+
+	// Session resumption. Stateful sessions are kept in a cache of the
+	// given size (zero to disable); stateless tickets are issued unless
+	// disabled by the ssl_session_tickets option above.
+	const long session_cache_size
+	{
+		opts.get<long>("ssl_session_cache_size", 20480L)
+	};
+
+	const string_view session_id_context
+	{
+		name.data(), std::min(name.size(), size_t(SSL_MAX_SID_CTX_LENGTH))
+	};
+
+	SSL_CTX_set_ex_data(ssl.native_handle(), acceptor_ex_index(), this);
+	SSL_CTX_set_session_cache_mode(ssl.native_handle(), session_cache_size? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+	SSL_CTX_sess_set_cache_size(ssl.native_handle(), session_cache_size);
+	SSL_CTX_set_timeout(ssl.native_handle(), seconds(ssl_session_timeout).count());
+	SSL_CTX_set_session_id_context(ssl.native_handle(), reinterpret_cast<const uint8_t *>(session_id_context.data()), session_id_context.size());
+	SSL_CTX_set_tlsext_ticket_key_cb(ssl.native_handle(), ircd_net_acceptor_handle_ticket);
+	log::debug
+	{
+		log, "%s session cache:%ld tickets:%b timeout:%lds",
+		string(logheadbuf, *this),
+		session_cache_size,
+		!(flags & SSL_OP_NO_TICKET),
+		seconds(ssl_session_timeout).count()
+	};
 }
 
 //
@@ -2341,6 +2609,356 @@ ircd::net::listener_udp::datagram::datagram(const mutable_buffer &buf,
 ,flag{flag}
 {}
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// net/offload.h
+//
+
+namespace ircd::net::offload
+{
+	struct job;
+
+	extern stats::item stats_handshakes;
+	extern stats::item stats_steps;
+	extern stats::item stats_errors;
+	extern stats::item stats_queued;
+	extern stats::item stats_queued_max;
+	extern stats::item stats_threads;
+	extern stats::item stats_latency_queue;
+	extern stats::item stats_latency_exec;
+	extern stats::item stats_latency_total;
+
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<std::shared_ptr<job>> queue;
+	std::vector<std::thread> threads;
+	size_t sleeping;
+	bool termination;
+
+	static uint64_t now() noexcept;
+	static void complete(std::shared_ptr<job>) noexcept;
+	static void execute(std::shared_ptr<job>) noexcept;
+	static void worker() noexcept;
+	static void submit(std::shared_ptr<job>);
+	static void wait(std::shared_ptr<job>);
+}
+
+/// State for one socket's handshake, carried between the main thread and
+/// the workers for each step.
+struct ircd::net::offload::job
+{
+	std::shared_ptr<socket> sock;
+	socket::handshake_type type;
+	offload::handler handler;
+	boost::system::error_code ec;
+	uint64_t began {0};
+	uint64_t submitted {0};
+	uint64_t started {0};
+	uint64_t finished {0};
+	size_t steps {0};
+};
+
+decltype(ircd::net::offload::enable)
+ircd::net::offload::enable
+{
+	{ "name",     "ircd.net.offload.enable" },
+	{ "default",  false                     },
+};
+
+decltype(ircd::net::offload::thread_max)
+ircd::net::offload::thread_max
+{
+	{ "name",     "ircd.net.offload.thread.max"                         },
+	{ "default",  long(std::max(std::thread::hardware_concurrency() / 2, 1U)) },
+};
+
+/// Count of handshakes conducted by the offload system.
+decltype(ircd::net::offload::stats_handshakes)
+ircd::net::offload::stats_handshakes
+{
+	{ "name", "ircd.net.offload.handshakes" },
+};
+
+/// Count of steps submitted to the workers; a handshake takes one step for
+/// each flight received from the peer.
+decltype(ircd::net::offload::stats_steps)
+ircd::net::offload::stats_steps
+{
+	{ "name", "ircd.net.offload.steps" },
+};
+
+/// Count of handshakes which completed with an error.
+decltype(ircd::net::offload::stats_errors)
+ircd::net::offload::stats_errors
+{
+	{ "name", "ircd.net.offload.errors" },
+};
+
+/// Number of steps currently submitted to the workers and not yet returned.
+decltype(ircd::net::offload::stats_queued)
+ircd::net::offload::stats_queued
+{
+	{ "name", "ircd.net.offload.queued" },
+};
+
+/// Maximum observed value of ircd.net.offload.queued.
+decltype(ircd::net::offload::stats_queued_max)
+ircd::net::offload::stats_queued_max
+{
+	{ "name", "ircd.net.offload.queued.max" },
+};
+
+decltype(ircd::net::offload::stats_threads)
+ircd::net::offload::stats_threads
+{
+	{ "name", "ircd.net.offload.threads" },
+};
+
+/// Nanoseconds accumulated between submitting a step and a worker starting it.
+decltype(ircd::net::offload::stats_latency_queue)
+ircd::net::offload::stats_latency_queue
+{
+	{ "name", "ircd.net.offload.latency.queue" },
+};
+
+/// Nanoseconds accumulated conducting handshake steps on the workers.
+decltype(ircd::net::offload::stats_latency_exec)
+ircd::net::offload::stats_latency_exec
+{
+	{ "name", "ircd.net.offload.latency.exec" },
+};
+
+/// Nanoseconds accumulated between starting a handshake and its completion
+/// being received back on the main thread.
+decltype(ircd::net::offload::stats_latency_total)
+ircd::net::offload::stats_latency_total
+{
+	{ "name", "ircd.net.offload.latency.total" },
+};
+
+/// Conducts the handshake for the socket on the offload workers. The
+/// handler is called on the main thread just as it would be for
+/// async_handshake(). Returns false if the offload is not available; the
+/// caller should then conduct the handshake itself.
+bool
+ircd::net::offload::handshake(const std::shared_ptr<socket> &sock,
+                              const socket::handshake_type &type,
+                              const handler &handler)
+{
+	assert(bool(sock));
+	if(!enable || !thread_max || termination)
+		return false;
+
+	// Each step advances the handshake until it would block on the socket;
+	// the main event loop then waits for readability before the next step.
+	boost::system::error_code ec;
+	sock->sd.non_blocking(true, ec);
+	if(unlikely(ec))
+		return false;
+
+	auto job
+	{
+		std::make_shared<offload::job>()
+	};
+
+	job->sock = sock;
+	job->type = type;
+	job->handler = handler;
+	job->began = now();
+	stats_handshakes += 1;
+	submit(std::move(job));
+	return true;
+}
+
+void
+ircd::net::offload::submit(std::shared_ptr<job> job)
+{
+	assert(is_main_thread());
+	assert(!job->sock->offloaded);
+
+	std::unique_lock lock
+	{
+		mutex
+	};
+
+	if(unlikely(termination))
+	{
+		lock.unlock();
+		job->ec = boost::system::errc::make_error_code(boost::system::errc::operation_canceled);
+		ircd::post([job(std::move(job))]() mutable
+		{
+			complete(std::move(job));
+		});
+
+		return;
+	}
+
+	if(!sleeping && threads.size() < size_t(thread_max))
+	{
+		threads.emplace_back(&offload::worker);
+		stats_threads = threads.size();
+	}
+
+	job->sock->offloaded = true;
+	job->submitted = now();
+	queue.emplace_back(std::move(job));
+	lock.unlock();
+	cond.notify_one();
+
+	stats_steps += 1;
+	stats_queued += 1;
+	if(stats_queued.val > stats_queued_max.val)
+		stats_queued_max = stats_queued.val;
+}
+
+/// Executed on a worker thread.
+void
+ircd::net::offload::worker()
+noexcept
+{
+	std::unique_lock lock
+	{
+		mutex
+	};
+
+	while(1)
+	{
+		++sleeping;
+		cond.wait(lock, []
+		{
+			return termination || !queue.empty();
+		});
+
+		--sleeping;
+		if(queue.empty())
+			break;
+
+		auto job(std::move(queue.front()));
+		queue.pop_front();
+		lock.unlock();
+		execute(std::move(job));
+		lock.lock();
+	}
+}
+
+/// Executed on a worker thread. The socket is used exclusively by this
+/// thread until the completion is posted back to the main thread.
+///
+/// The synchronous handshake is resumable: when the socket has no more
+/// input it returns would_block with the SSL state intact. Handshake flights
+/// are far smaller than the socket's send buffer so writes are not expected
+/// to block; if one does the handshake fails and the peer has to retry.
+void
+ircd::net::offload::execute(std::shared_ptr<job> job)
+noexcept
+{
+	job->started = now();
+	job->ec.clear();
+	job->sock->ssl.handshake(job->type, job->ec);
+	job->finished = now();
+
+	boost::asio::post(ios::get(), [job(std::move(job))]() mutable
+	{
+		complete(std::move(job));
+	});
+}
+
+/// Executed on the main thread after each step.
+void
+ircd::net::offload::complete(std::shared_ptr<job> job)
+noexcept
+{
+	using boost::system::errc::make_error_code;
+	using boost::system::errc::operation_canceled;
+
+	auto &sock(*job->sock);
+	if(likely(job->submitted))
+	{
+		stats_queued -= 1;
+		stats_latency_queue += job->started - job->submitted;
+		stats_latency_exec += job->finished - job->started;
+		job->submitted = 0;
+		job->steps++;
+	}
+
+	sock.offloaded = false;
+	const bool again
+	{
+		job->ec == boost::asio::error::would_block
+	};
+
+	// Socket was canceled (i.e. timed out) or disconnected during the step.
+	if(again && (sock.timedout || sock.fini || !sock.sd.is_open()))
+		job->ec = make_error_code(operation_canceled);
+
+	else if(again)
+		return wait(std::move(job));
+
+	stats_errors += bool(job->ec);
+	stats_latency_total += now() - job->began;
+
+	thread_local char ecbuf[64];
+	log::debug
+	{
+		log, "%s offloaded handshake steps:%zu %s",
+		loghead(sock),
+		job->steps,
+		string(ecbuf, job->ec)
+	};
+
+	assert(job->handler);
+	job->handler(job->ec);
+}
+
+/// Waits on the main event loop for the peer's next flight.
+void
+ircd::net::offload::wait(std::shared_ptr<job> job)
+{
+	static ios::descriptor desc
+	{
+		"ircd::net::offload wait"
+	};
+
+	auto &sock(*job->sock);
+	sock.sd.async_wait(ip::tcp::socket::wait_read, ios::handle(desc, [job]
+	(const boost::system::error_code &ec)
+	{
+		if(likely(!ec))
+			return submit(job);
+
+		job->ec = ec;
+		complete(job);
+	}));
+}
+
+void
+ircd::net::offload::fini()
+noexcept
+{
+	std::unique_lock lock
+	{
+		mutex
+	};
+
+	termination = true;
+	cond.notify_all();
+	lock.unlock();
+
+	// Workers drain the queue before exiting; the steps are non-blocking.
+	for(auto &thread : threads)
+		thread.join();
+
+	threads.clear();
+	stats_threads = 0;
+}
+
+uint64_t
+ircd::net::offload::now()
+noexcept
+{
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // net/scope_timeout.h
@@ -2465,6 +3083,93 @@ ircd::net::sslv23_client
 	boost::asio::ssl::context::method::sslv23_client
 };
 
+namespace ircd::net
+{
+	extern stats::item socket_handshake_full;
+	extern stats::item socket_handshake_resumed;
+
+	static void cancel_offloaded(const std::weak_ptr<socket>);
+}
+
+/// Count of outbound handshakes which did not resume a session.
+decltype(ircd::net::socket_handshake_full)
+ircd::net::socket_handshake_full
+{
+	{ "name", "ircd.net.socket.handshake.full" },
+};
+
+/// Count of outbound handshakes which resumed the session offered from the
+/// open_opts session cache.
+decltype(ircd::net::socket_handshake_resumed)
+ircd::net::socket_handshake_resumed
+{
+	{ "name", "ircd.net.socket.handshake.resumed" },
+};
+
+/// Index of the socket instance in the ex_data of its SSL.
+int
+ircd::net::socket_ex_index()
+{
+	static const int ret
+	{
+		SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr)
+	};
+
+	return ret;
+}
+
+/// Called by OpenSSL when the remote issues a session (for TLS 1.3 this is
+/// after the handshake). The session is saved to the socket's cache. This
+/// might be called on an offload thread, in which case the save is posted
+/// to the main thread where the cache is otherwise used.
+static int
+ircd_net_socket_handle_session(SSL *const s,
+                               SSL_SESSION *const session)
+noexcept try
+{
+	using namespace ircd;
+
+	assert(s && session);
+	auto *const socket
+	{
+		reinterpret_cast<net::socket *>(SSL_get_ex_data(s, net::socket_ex_index()))
+	};
+
+	if(!socket || !socket->session)
+		return 0;
+
+	std::string der
+	{
+		openssl::session(*session)
+	};
+
+	if(der.empty())
+		return 0;
+
+	if(likely(is_main_thread()))
+	{
+		*socket->session = std::move(der);
+		return 0;
+	}
+
+	boost::asio::post(ios::get(), [cache(socket->session), der(std::move(der))]
+	{
+		*cache = der;
+	});
+
+	// Zero indicates no reference to the session was kept here.
+	return 0;
+}
+catch(const std::exception &e)
+{
+	ircd::log::error
+	{
+		ircd::net::log, "Socket session callback :%s", e.what()
+	};
+
+	return 0;
+}
+
 decltype(ircd::net::socket::count)
 ircd::net::socket::count
 {};
@@ -2590,7 +3295,21 @@ ircd::net::socket::handshake(const open_opts &opts,
 	if(opts.send_sni && server_name(opts))
 		openssl::server_name(*this, server_name(opts));
 
+	// Offer the cached session for resumption and register this socket to
+	// receive any new session from the remote.
+	if(opts.session)
+	{
+		SSL &ssl(*this);
+		session = opts.session;
+		SSL_set_ex_data(&ssl, socket_ex_index(), this);
+		if(!session->empty() && !openssl::session(ssl, string_view{*session}))
+			session->clear();
+	}
+
 	ssl.set_verify_callback(std::move(verify_handler));
+	if(offload::handshake(shared_from(*this), handshake_type::client, handshake_handler))
+		return;
+
 	ssl.async_handshake(handshake_type::client, ios::handle(desc, std::move(handshake_handler)));
 }
 
@@ -2605,6 +3324,24 @@ try
 		return;
 	}
 
+	// A handshake step on an offload thread has exclusive use of the socket
+	// until it returns to the main thread; the disconnect is put off until
+	// then. The step is non-blocking so this is brief.
+	if(unlikely(offloaded))
+	{
+		static ios::descriptor desc
+		{
+			"ircd::net::socket disconnect offloaded"
+		};
+
+		ircd::post(desc, [this, s(shared_from(*this)), opts, callback(std::move(callback))]
+		{
+			disconnect(opts, callback);
+		});
+
+		return;
+	}
+
 	log::debug
 	{
 		log, "%s disconnect type:%d user: in:%zu out:%zu",
@@ -2997,6 +3734,30 @@ catch(const std::exception &e)
 	call_user(callback, ec);
 }
 
+/// Cancels the socket on the main thread once no handshake step is in
+/// progress on an offload thread.
+void
+ircd::net::cancel_offloaded(const std::weak_ptr<socket> wp)
+{
+	static ios::descriptor desc
+	{
+		"ircd::net::socket cancel offloaded"
+	};
+
+	ircd::post(desc, [wp]
+	{
+		const auto s(wp.lock());
+		if(!s || !s->sd.is_open())
+			return;
+
+		if(s->offloaded)
+			return cancel_offloaded(wp);
+
+		boost::system::error_code ec;
+		s->sd.cancel(ec);
+	});
+}
+
 void
 ircd::net::socket::handle_timeout(const std::weak_ptr<socket> wp,
                                   ec_handler callback,
@@ -3019,6 +3780,16 @@ noexcept try
 		{
 			assert(timedout == false);
 			timedout = true;
+
+			// A handshake step on an offload thread has exclusive use of the
+			// socket; the cancel is put off until it returns, as in
+			// disconnect(). The step sees timedout when it completes.
+			if(unlikely(offloaded))
+			{
+				cancel_offloaded(wp);
+				break;
+			}
+
 			sd.cancel();
 			break;
 		}
@@ -3248,6 +4019,11 @@ noexcept try
 	};
 	#endif
 
+	if(!ec && openssl::session_reused(*this))
+		socket_handshake_resumed += 1;
+	else if(!ec)
+		socket_handshake_full += 1;
+
 	// Toggles the behavior of non-async functions; see func comment
 	if(!ec)
 		blocking(*this, false);
@@ -3292,6 +4068,9 @@ catch(const std::exception &e)
 	call_user(callback, ec);
 }
 
+/// Called on the main thread, or on an offload thread during an offloaded
+/// handshake; it only uses the socket, the options copied into the bound
+/// handler, and the thread-safe logger.
 bool
 ircd::net::socket::handle_verify(const bool valid,
                                  asio::ssl::verify_context &vc,
@@ -3304,8 +4083,10 @@ noexcept try
 	// true to still continue.
 
 	// Socket ordered to shut down. We abort the verification here
-	// to allow the open_opts out of scope with the user.
-	if(fini || !sd.is_open())
+	// to allow the open_opts out of scope with the user. On an offload
+	// thread fini belongs to the main thread; the step's completion checks
+	// it there instead.
+	if((is_main_thread() && fini) || !sd.is_open())
 		return false;
 
 	// The user can set this option to bypass verification.
@@ -68,6 +68,63 @@ ircd::openssl::server_name(const SSL &ssl)
 	return ::SSL_get_servername(&ssl, type);
 }
 
+//
+// Session suite
+//
+
+bool
+ircd::openssl::session(SSL &ssl,
+                       const const_buffer &der)
+{
+	auto *in
+	{
+		reinterpret_cast<const uint8_t *>(data(der))
+	};
+
+	const custom_ptr<SSL_SESSION> session
+	{
+		::d2i_SSL_SESSION(nullptr, &in, size(der)), ::SSL_SESSION_free
+	};
+
+	if(!session)
+		return false;
+
+	return ::SSL_set_session(&ssl, session.get()) == 1;
+}
+
+std::string
+ircd::openssl::session(const SSL_SESSION &session_)
+{
+	auto &session
+	{
+		const_cast<SSL_SESSION &>(session_)
+	};
+
+	#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	if(!::SSL_SESSION_is_resumable(&session))
+		return {};
+	#endif
+
+	const int len
+	{
+		::i2d_SSL_SESSION(&session, nullptr)
+	};
+
+	if(len <= 0)
+		return {};
+
+	std::string ret(len, char{});
+	auto *out(reinterpret_cast<uint8_t *>(ret.data()));
+	::i2d_SSL_SESSION(&session, &out);
+	return ret;
+}
+
+bool
+ircd::openssl::session_reused(const SSL &ssl)
+{
+	return ::SSL_session_reused(const_cast<SSL *>(&ssl));
+}
+
 //
 // Cipher suite
 //
@@ -506,6 +506,11 @@ try
 		};
 	}
 
+	// Inflate a compressed request body (i.e from a federation origin). The
+	// decoded content is bounded by the method's payload_max as well.
+	if(head.content_encoding && ~opts->flags & CONTENT_DISCRETION)
+		content = decode_content(client, head, content);
+
 	// We take the extra step here to clear the assignment to client.request
 	// when this request stack has finished for two reasons:
 	// - It allows other ctxs to peep at the client::list to see what this
@@ -577,6 +582,34 @@ catch(...)
 	throw;
 }
 
+ircd::string_view
+ircd::resource::method::decode_content(client &client,
+                                       const http::request::head &head,
+                                       const string_view &content)
+const
+{
+	const auto coding
+	{
+		http::coding::parse(head.content_encoding)
+	};
+
+	if(coding == http::coding::IDENTITY)
+		return content;
+
+	unique_buffer<mutable_buffer> buf
+	{
+		opts->payload_max
+	};
+
+	const string_view decoded
+	{
+		http::coding::decode(buf, content, coding)
+	};
+
+	client.content_buffer = std::move(buf);
+	return decoded;
+}
+
 void
 ircd::resource::method::call_handler(client &client,
                                      resource::request &request)
@@ -700,24 +733,38 @@ const
 	if(!request.access_token)
 		return {};
 
-	static const m::event::fetch::opts fopts
+	if(const auto *const cached{token_cache::find(request.access_token)})
+		request.user_id = cached->user_id;
+	else
 	{
-		m::event::keys::include
+		// The token may be revoked while the query below yields.
+		const auto generation
 		{
-			"sender"
-		}
-	};
+			token_cache::generation
+		};
 
-	const m::room::state tokens{m::user::tokens, &fopts};
-	tokens.get(std::nothrow, "ircd.access_token", request.access_token, [&request]
-	(const m::event &event)
-	{
-		// The user sent this access token to the tokens room
-		request.user_id = m::user::id
+		static const m::event::fetch::opts fopts
 		{
-			at<"sender"_>(event)
+			m::event::keys::include
+			{
+				"sender"
+			}
 		};
-	});
+
+		const m::room::state tokens{m::user::tokens, &fopts};
+		tokens.get(std::nothrow, "ircd.access_token", request.access_token, [&request]
+		(const m::event &event)
+		{
+			// The user sent this access token to the tokens room
+			request.user_id = m::user::id
+			{
+				at<"sender"_>(event)
+			};
+		});
+
+		if(generation == token_cache::generation)
+			token_cache::set(request.access_token, request.user_id);
+	}
 
 	if(!request.user_id && requires_auth)
 		throw m::error
@@ -743,6 +790,18 @@ ircd::resource::method::x_matrix_verify_destination
 	{ "default",  true                                        },
 };
 
+decltype(ircd::resource::method::x_matrix_verified)
+ircd::resource::method::x_matrix_verified
+{
+	{ "name", "ircd.resource.x_matrix.verified" },
+};
+
+decltype(ircd::resource::method::x_matrix_invalid)
+ircd::resource::method::x_matrix_invalid
+{
+	{ "name", "ircd.resource.x_matrix.invalid" },
+};
+
 ircd::string_view
 ircd::resource::method::verify_origin(client &client,
                                       request &request)
@@ -792,11 +851,17 @@ const try
 	};
 
 	if(x_matrix_verify_origin && !object.verify(x_matrix.key, x_matrix.sig))
+	{
+		x_matrix_invalid += 1;
 		throw m::error
 		{
 			http::FORBIDDEN, "M_INVALID_SIGNATURE",
 			"The X-Matrix Authorization is invalid."
 		};
+	}
+
+	if(x_matrix_verify_origin)
+		x_matrix_verified += 1;
 
 	request.node_id = {m::node::id::origin, x_matrix.origin};
 	request.origin = x_matrix.origin;
@@ -859,11 +924,189 @@ catch(const std::exception &e)
 	};
 }
 
+//
+// method::token_cache
+//
+
+decltype(ircd::resource::method::token_cache::max)
+ircd::resource::method::token_cache::max
+{
+	{ "name",     "ircd.resource.token_cache.max" },
+	{ "default",  65536L                          },
+};
+
+decltype(ircd::resource::method::token_cache::ttl)
+ircd::resource::method::token_cache::ttl
+{
+	{ "name",     "ircd.resource.token_cache.ttl" },
+	{ "default",  300L                            },
+};
+
+decltype(ircd::resource::method::token_cache::negative_max)
+ircd::resource::method::token_cache::negative_max
+{
+	{ "name",     "ircd.resource.token_cache.negative.max" },
+	{ "default",  4096L                                    },
+};
+
+decltype(ircd::resource::method::token_cache::negative_ttl)
+ircd::resource::method::token_cache::negative_ttl
+{
+	{ "name",     "ircd.resource.token_cache.negative.ttl" },
+	{ "default",  60L                                      },
+};
+
+decltype(ircd::resource::method::token_cache::hits)
+ircd::resource::method::token_cache::hits
+{
+	{ "name", "ircd.resource.token_cache.hits" },
+};
+
+decltype(ircd::resource::method::token_cache::misses)
+ircd::resource::method::token_cache::misses
+{
+	{ "name", "ircd.resource.token_cache.misses" },
+};
+
+decltype(ircd::resource::method::token_cache::negative_hits)
+ircd::resource::method::token_cache::negative_hits
+{
+	{ "name", "ircd.resource.token_cache.negative.hits" },
+};
+
+decltype(ircd::resource::method::token_cache::map)
+ircd::resource::method::token_cache::map;
+
+decltype(ircd::resource::method::token_cache::negatives)
+ircd::resource::method::token_cache::negatives;
+
+decltype(ircd::resource::method::token_cache::generation)
+ircd::resource::method::token_cache::generation;
+
+void
+ircd::resource::method::token_cache::clear()
+{
+	++generation;
+	map.clear();
+	negatives = 0;
+}
+
+bool
+ircd::resource::method::token_cache::clear(const string_view &token)
+{
+	++generation;
+	const auto it
+	{
+		map.find(std::hash<string_view>{}(token))
+	};
+
+	if(it == end(map) || it->second.token != token)
+		return false;
+
+	negatives -= empty(it->second.user_id);
+	map.erase(it);
+	return true;
+}
+
+/// Enter the result of a lookup; an empty user_id enters the token as
+/// invalid. When the table is full an arbitrary entry is evicted.
+void
+ircd::resource::method::token_cache::set(const string_view &token,
+                                         const string_view &user_id)
+{
+	const bool negative
+	{
+		empty(user_id)
+	};
+
+	if(!size_t(max) || (negative && negatives >= size_t(negative_max)))
+		return;
+
+	const auto key
+	{
+		std::hash<string_view>{}(token)
+	};
+
+	auto it(map.find(key));
+	if(it != end(map))
+	{
+		negatives -= empty(it->second.user_id);
+		map.erase(it);
+	}
+	else if(map.size() >= size_t(max))
+	{
+		negatives -= empty(begin(map)->second.user_id);
+		map.erase(begin(map));
+	}
+
+	entry &e(map[key]);
+	e.token = std::string{token};
+	e.user_id = m::user::id::buf{user_id};
+	e.expires = now<steady_point>() + (negative? seconds(negative_ttl): seconds(ttl));
+
+	negatives += negative;
+}
+
+/// Returns the entry for the token if cached; the user_id of the entry is
+/// empty for an invalid token.
+const ircd::resource::method::token_cache::entry *
+ircd::resource::method::token_cache::find(const string_view &token)
+{
+	const auto it
+	{
+		map.find(std::hash<string_view>{}(token))
+	};
+
+	if(it == end(map) || it->second.token != token)
+	{
+		misses += 1;
+		return nullptr;
+	}
+
+	const auto &e(it->second);
+	if(e.expires < now<steady_point>())
+	{
+		negatives -= empty(e.user_id);
+		map.erase(it);
+		misses += 1;
+		return nullptr;
+	}
+
+	if(!empty(e.user_id))
+	{
+		hits += 1;
+		return &e;
+	}
+
+	negative_hits += 1;
+	return &e;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // resource/response.h
 //
 
+namespace ircd
+{
+	static int encoding_level(const http::coding::type &);
+	static string_view encoding_headers(const mutable_buffer &, const string_view &headers, const http::coding::type &);
+}
+
+/// Count of content bytes supplied to a response encoder.
+decltype(ircd::resource::response::encoding_bytes_in)
+ircd::resource::response::encoding_bytes_in
+{
+	{ "name", "ircd.resource.response.encoding.bytes_in" },
+};
+
+/// Count of encoded bytes produced for responses.
+decltype(ircd::resource::response::encoding_bytes_out)
+ircd::resource::response::encoding_bytes_out
+{
+	{ "name", "ircd.resource.response.encoding.bytes_out" },
+};
+
 //
 // resource::response::chunked
 //
@@ -928,9 +1171,37 @@ ircd::resource::response::chunked::chunked(client &client,
                                            const string_view &content_type,
                                            const string_view &headers,
                                            const size_t &buffer_size)
+:chunked
+{
+	client,
+	code,
+	content_type,
+	headers,
+	buffer_size,
+	encoding(client, content_type, headers)
+}
+{
+}
+
+/// The length of chunked content is not known in advance so the minimum size
+/// for encoding does not apply here; the coding is used whenever negotiated.
+ircd::resource::response::chunked::chunked(client &client,
+                                           const http::code &code,
+                                           const string_view &content_type,
+                                           const string_view &headers,
+                                           const size_t &buffer_size,
+                                           const http::coding::type &coding)
 :response
 {
-	client, code, content_type, size_t(-1), headers
+	client, code, content_type, size_t(-1), [&headers, &coding]
+	{
+		// Composed into TLS and copied again by the head before any
+		// context switch, like the headers of the other constructors.
+		thread_local char buffer[4_KiB];
+		return coding != http::coding::IDENTITY?
+			encoding_headers(buffer, headers, coding):
+			headers;
+	}()
 }
 ,c
 {
@@ -940,6 +1211,13 @@ ircd::resource::response::chunked::chunked(client &client,
 {
 	buffer_size
 }
+,encoder
+{
+	coding,
+	encoding_level(coding),
+	int(encoding_window),
+	size_t(encoding_buffer_size)
+}
 {
 	assert(!empty(content_type));
 }
@@ -980,9 +1258,13 @@ ircd::resource::response::chunked::finish()
 ircd::const_buffer
 ircd::resource::response::chunked::flush(const const_buffer &buf)
 {
+	write(buf);
+
+	// The input is consumed whole even when the encoded output differs
+	// in size; nothing is consumed once the client has gone away.
 	const const_buffer wrote
 	{
-		data(buf), write(buf)
+		data(buf), c? size(buf) : 0UL
 	};
 
 	return wrote;
@@ -991,7 +1273,6 @@ ircd::resource::response::chunked::flush(const const_buffer &buf)
 size_t
 ircd::resource::response::chunked::write(const const_buffer &chunk,
                                          const bool &ignore_empty)
-try
 {
 	size_t ret{0};
 
@@ -1001,6 +1282,46 @@ try
 	if(ignore_empty && empty(chunk))
 		return ret;
 
+	if(!encoder)
+		return write_chunk(chunk);
+
+	// Each write is flushed through the codec so the client can make
+	// progress on what it has. The empty chunk terminates the response, so
+	// the codec's stream is finished first and its trailer precedes it.
+	const auto mode
+	{
+		empty(chunk)?
+			http::coding::encoder::FINISH:
+			http::coding::encoder::SYNC
+	};
+
+	const size_t encoded
+	{
+		encoder(chunk, mode, [this, &ret]
+		(const const_buffer &buf)
+		{
+			ret += write_chunk(buf);
+		})
+	};
+
+	encoding_bytes_in += size(chunk);
+	encoding_bytes_out += encoded;
+
+	if(mode == http::coding::encoder::FINISH)
+		ret += write_chunk(const_buffer{});
+
+	return ret;
+}
+
+size_t
+ircd::resource::response::chunked::write_chunk(const const_buffer &chunk)
+try
+{
+	size_t ret{0};
+
+	if(!c)
+		return ret;
+
 	//TODO: bring iov from net::socket -> net::write_() -> client::write_()
 	char headbuf[32];
 	ret += c->write_all(http::writechunk(headbuf, size(chunk)));
@@ -1213,6 +1534,57 @@ ircd::resource::response::response(client &client,
 {
 	assert(empty(content) || !empty(content_type));
 
+	const auto coding
+	{
+		size(content) >= size_t(encoding_min_size)?
+			encoding(client, content_type, headers):
+			http::coding::IDENTITY
+	};
+
+	if(coding != http::coding::IDENTITY)
+	{
+		const unique_buffer<mutable_buffer> buf
+		{
+			size(content)
+		};
+
+		// The encoding is abandoned if it would not be any smaller.
+		size_t len{0};
+		http::coding::encoder encoder
+		{
+			coding, encoding_level(coding), int(encoding_window), size_t(encoding_buffer_size)
+		};
+
+		encoder(content, http::coding::encoder::FINISH, [&buf, &len]
+		(const const_buffer &piece)
+		{
+			if(len + size(piece) < size(buf))
+				copy(buf + len, piece);
+
+			len += size(piece);
+		});
+
+		if(len < size(content))
+		{
+			char headers_buf[4_KiB];
+			response
+			{
+				client, code, content_type, len, encoding_headers(headers_buf, headers, coding)
+			};
+
+			encoding_bytes_in += size(content);
+			encoding_bytes_out += len;
+
+			const size_t written
+			{
+				client.write_all(const_buffer{data(buf), len})
+			};
+
+			assert(written == len);
+			return;
+		}
+	}
+
 	// Head gets sent
 	response
 	{
@@ -1230,6 +1602,120 @@ ircd::resource::response::response(client &client,
 	assert(written == size(content));
 }
 
+decltype(ircd::resource::response::encoding_enable)
+ircd::resource::response::encoding_enable
+{
+	{ "name",      "ircd.resource.response.encoding.enable" },
+	{ "default",   true                                     },
+};
+
+decltype(ircd::resource::response::encoding_min_size)
+ircd::resource::response::encoding_min_size
+{
+	{ "name",      "ircd.resource.response.encoding.min_size" },
+	{ "default",   long(1_KiB)                                },
+	{ "help",      "Content smaller than this is sent as-is." },
+};
+
+decltype(ircd::resource::response::encoding_buffer_size)
+ircd::resource::response::encoding_buffer_size
+{
+	{ "name",      "ircd.resource.response.encoding.buffer_size" },
+	{ "default",   long(16_KiB)                                  },
+};
+
+decltype(ircd::resource::response::encoding_window)
+ircd::resource::response::encoding_window
+{
+	{ "name",      "ircd.resource.response.encoding.window" },
+	{ "default",   15L                                      },
+	{ "help",      "Log2 of the codec window; bounds the memory of each stream." },
+};
+
+decltype(ircd::resource::response::encoding_gzip_level)
+ircd::resource::response::encoding_gzip_level
+{
+	{ "name",      "ircd.resource.response.encoding.gzip.level" },
+	{ "default",   6L                                           },
+};
+
+decltype(ircd::resource::response::encoding_zstd_level)
+ircd::resource::response::encoding_zstd_level
+{
+	{ "name",      "ircd.resource.response.encoding.zstd.level" },
+	{ "default",   3L                                           },
+};
+
+/// Select the Content-Coding for a response to the client's current request.
+/// IDENTITY unless enabled, acceptable to the client, worthwhile for the
+/// content type, and the handler hasn't supplied a Content-Encoding itself.
+ircd::http::coding::type
+ircd::resource::response::encoding(const client &client,
+                                   const string_view &content_type,
+                                   const string_view &headers)
+{
+	if(!encoding_enable)
+		return http::coding::IDENTITY;
+
+	const auto &accept_encoding
+	{
+		client.request.head.accept_encoding
+	};
+
+	if(!accept_encoding)
+		return http::coding::IDENTITY;
+
+	const auto mime
+	{
+		strip(split(content_type, ';').first)
+	};
+
+	const bool compressible
+	{
+		startswith(mime, "text/") ||
+		endswith(mime, "json") ||
+		endswith(mime, "javascript") ||
+		endswith(mime, "xml")
+	};
+
+	if(!compressible)
+		return http::coding::IDENTITY;
+
+	if(has(http::headers{headers}, "content-encoding"))
+		return http::coding::IDENTITY;
+
+	return http::coding::negotiate(accept_encoding);
+}
+
+ircd::string_view
+ircd::encoding_headers(const mutable_buffer &buf,
+                       const string_view &headers,
+                       const http::coding::type &coding)
+{
+	const http::header addl[]
+	{
+		{ "Content-Encoding",  http::coding::reflect(coding) },
+		{ "Vary",              "Accept-Encoding"             },
+	};
+
+	window_buffer sb{buf};
+	sb([&headers](const mutable_buffer &buf)
+	{
+		return copy(buf, headers);
+	});
+
+	http::write(sb, addl);
+	return sb.completed();
+}
+
+int
+ircd::encoding_level(const http::coding::type &coding)
+{
+	return coding == http::coding::ZSTD?
+		int(resource::response::encoding_zstd_level):
+		int(resource::response::encoding_gzip_level);
+}
+
 decltype(ircd::resource::response::access_control_allow_origin)
 ircd::resource::response::access_control_allow_origin
 {
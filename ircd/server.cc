@@ -574,6 +574,7 @@ ircd::server::peer::peer(const net::hostport &hostport,
 
 	this->open_opts.server_name = this->hostcanon;        // Send SNI for this name.
 	this->open_opts.common_name = this->hostcanon;        // Cert verify this name.
+	this->open_opts.session = std::make_shared<std::string>(); // Resume over links.
 
 	if(rfc3986::valid(std::nothrow, rfc3986::parser::ip_address, host(this->open_opts.hostport)))
 		this->remote =
@@ -627,6 +628,7 @@ void
 ircd::server::peer::err_set(A&&... args)
 {
 	this->e = std::make_unique<err>(std::forward<A>(args)...);
+	score_error();
 }
 
 ircd::string_view
@@ -894,6 +896,7 @@ ircd::server::peer::handle_error(link &link,
                                  std::exception_ptr eptr)
 {
 	assert(bool(eptr));
+	score_error();
 	link.cancel_committed(eptr);
 	log::derror
 	{
@@ -949,6 +952,7 @@ ircd::server::peer::handle_error(link &link,
 		e.what()
 	};
 
+	score_error();
 	link.cancel_committed(std::make_exception_ptr(e));
 	link.close(net::dc::RST);
 }
@@ -992,6 +996,7 @@ noexcept try
 		link.tag_count() - 1
 	};
 
+	score_done(tag);
 	if(link.tag_committed() >= link.tag_commit_max())
 		link.wait_writable();
 }
@@ -1417,6 +1422,78 @@ const
 	return write_bytes;
 }
 
+decltype(ircd::server::peer::score_errors_max)
+ircd::server::peer::score_errors_max
+{
+	{ "name",     "ircd.server.peer.score.errors_max" },
+	{ "default",  3L                                  },
+};
+
+/// A peer is healthy when it has no cached error and has not failed more
+/// than a few times in a row.
+bool
+ircd::server::peer::healthy()
+const
+{
+	return !err_has() && score_errors_consecutive < size_t(score_errors_max);
+}
+
+/// Latency at the percentile of recent responses; zero when none have
+/// been measured.
+ircd::milliseconds
+ircd::server::peer::latency(const double &percentile)
+const
+{
+	const size_t count
+	{
+		std::min(score_count, score_latency.size())
+	};
+
+	if(!count)
+		return milliseconds{0};
+
+	std::array<uint32_t, SCORE_SAMPLES> samples;
+	std::copy(begin(score_latency), begin(score_latency) + count, begin(samples));
+
+	const size_t pos
+	{
+		std::min(size_t(percentile * count), count - 1)
+	};
+
+	std::nth_element(begin(samples), begin(samples) + pos, begin(samples) + count);
+	return milliseconds
+	{
+		samples[pos]
+	};
+}
+
+/// Record the time from the first write of the tag to its completion. A
+/// server error status counts against the peer instead.
+void
+ircd::server::peer::score_done(const tag &tag)
+{
+	if(tag.state.sent == steady_point{})
+		return;
+
+	if(uint(tag.state.status) >= 500)
+		return score_error();
+
+	const auto elapsed
+	{
+		duration_cast<milliseconds>(now<steady_point>() - tag.state.sent)
+	};
+
+	score_latency[score_count++ % score_latency.size()] = elapsed.count();
+	score_errors_consecutive = 0;
+}
+
+void
+ircd::server::peer::score_error()
+{
+	++score_errors;
+	++score_errors_consecutive;
+}
+
 size_t
 ircd::server::peer::read_remaining()
 const
@@ -2646,6 +2723,9 @@ ircd::server::tag::wrote_buffer(const const_buffer &buffer)
 {
 	assert(request);
 	const auto &req{*request};
+	if(!state.written)
+		state.sent = now<steady_point>();
+
 	state.written += size(buffer);
 
 	if(state.written <= size(req.out.head))
@@ -631,6 +631,31 @@ ircd::m::sync::linear_proffer_event_one(data &data)
 // longpoll
 //
 
+decltype(ircd::m::sync::longpoll::stats_events)
+ircd::m::sync::longpoll::stats_events
+{
+	{ "name", "ircd.client.sync.longpoll.events" },
+};
+
+decltype(ircd::m::sync::longpoll::stats_broadcasts)
+ircd::m::sync::longpoll::stats_broadcasts
+{
+	{ "name", "ircd.client.sync.longpoll.broadcasts" },
+};
+
+/// The ratio of wakeups to events is the fan-out per event.
+decltype(ircd::m::sync::longpoll::stats_wakeups)
+ircd::m::sync::longpoll::stats_wakeups
+{
+	{ "name", "ircd.client.sync.longpoll.wakeups" },
+};
+
+decltype(ircd::m::sync::longpoll::stats_hits)
+ircd::m::sync::longpoll::stats_hits
+{
+	{ "name", "ircd.client.sync.longpoll.hits" },
+};
+
 decltype(ircd::m::sync::longpoll::notified)
 ircd::m::sync::longpoll::notified
 {
@@ -649,13 +674,79 @@ ircd::m::sync::longpoll::handle_notify(const m::event &event,
 		return;
 
 	if(!polling)
+		return;
+
+	const std::shared_ptr<const accepted> accepted
 	{
-		queue.clear();
+		std::make_shared<longpoll::accepted>(eval)
+	};
+
+	stats_events += 1;
+	const auto &room_id
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	// Without a room there's no index to consult; everybody gets it.
+	if(!room_id)
+	{
+		stats_broadcasts += 1;
+		for(const auto &[user_id, poller] : users)
+			wake(*poller, accepted);
+
+		return;
+	}
+
+	// Presence is written to the sender's user room which nobody else polls;
+	// it is not filtered by room when synced so everybody gets it.
+	if(json::get<"type"_>(event) == "ircd.presence")
+	{
+		if(!my_host(json::get<"origin"_>(event)))
+			return;
+
+		stats_broadcasts += 1;
+		for(const auto &[user_id, poller] : users)
+			wake(*poller, accepted);
+
 		return;
 	}
 
-	queue.emplace_back(eval);
-	dock.notify_all();
+	auto pit(rooms.equal_range(room_id));
+	for(; pit.first != pit.second; ++pit.first)
+		wake(*pit.first->second, accepted);
+
+	// Read receipts are written to the reader's user room too, but they are
+	// synced to the members of the room named by the state_key.
+	if(json::get<"type"_>(event) == "ircd.read")
+	{
+		auto rit(rooms.equal_range(json::get<"state_key"_>(event)));
+		for(; rit.first != rit.second; ++rit.first)
+			wake(*rit.first->second, accepted);
+
+		return;
+	}
+
+	// Membership changes concern the target even if they weren't in the
+	// room when their poll started (i.e. invites and joins).
+	if(json::get<"type"_>(event) != "m.room.member")
+		return;
+
+	auto uit(users.equal_range(json::get<"state_key"_>(event)));
+	for(; uit.first != uit.second; ++uit.first)
+		wake(*uit.first->second, accepted);
+}
+
+void
+ircd::m::sync::longpoll::wake(poller &poller,
+                              const std::shared_ptr<const accepted> &accepted)
+{
+	// Already delivered via another index for this event.
+	if(!poller.queue.empty() && poller.queue.back() == accepted)
+		return;
+
+	poller.queue.emplace_back(accepted);
+	poller.dock.notify_one();
+	stats_wakeups += 1;
 }
 
 bool
@@ -668,9 +759,23 @@ try
 		96_KiB
 	};
 
-	const scope_count polling{longpoll::polling}; do
+	const scope_count polling{longpoll::polling};
+	longpoll::poller poller
 	{
-		if(!dock.wait_until(args.timesout))
+		data
+	};
+
+	// Registration may have yielded; anything retired in the meantime was
+	// not delivered here so the client has to come back for it.
+	if(vm::sequence::retired >= data.range.second)
+		return false;
+
+	do
+	{
+		if(!poller.dock.wait_until(args.timesout, [&poller]
+		{
+			return !poller.queue.empty();
+		}))
 			break;
 
 		assert(data.client && data.client->sock);
@@ -678,25 +783,20 @@ try
 			break;
 
 		check(*data.client->sock);
-		if(queue.empty())
-			continue;
-
-		const auto &accepted
+		const std::shared_ptr<const accepted> accepted
 		{
-			queue.front()
+			std::move(poller.queue.front())
 		};
 
-		const unwind pop{[]
-		{
-			if(longpoll::polling <= 1)
-				queue.pop_front();
-		}};
-
+		poller.queue.pop_front();
 		if(polylog_only)
 			break;
 
-		if(handle(data, args, accepted, scratch))
+		if(handle(data, args, *accepted, scratch))
+		{
+			stats_hits += 1;
 			return true;
+		}
 	}
 	while(1);
 
@@ -725,6 +825,37 @@ catch(const std::exception &e)
 	throw;
 }
 
+//
+// longpoll::poller
+//
+
+ircd::m::sync::longpoll::poller::poller(sync::data &data)
+:data{data}
+{
+	room_ids.emplace_back(data.user_room.room_id);
+	data.user_rooms.for_each([this]
+	(const m::room &room, const string_view &membership)
+	{
+		room_ids.emplace_back(room.room_id);
+	});
+
+	// The index keys refer to room_ids which must not grow after this point.
+	room_its.reserve(room_ids.size());
+	for(const auto &room_id : room_ids)
+		room_its.emplace_back(rooms.emplace(room_id, this));
+
+	user_it = users.emplace(data.user.user_id, this);
+}
+
+ircd::m::sync::longpoll::poller::~poller()
+noexcept
+{
+	for(const auto &it : room_its)
+		rooms.erase(it);
+
+	users.erase(user_it);
+}
+
 bool
 ircd::m::sync::longpoll::handle(data &data,
                                 const args &args,
@@ -741,6 +872,13 @@ ircd::m::sync::longpoll::handle(data &data,
 		data.event_idx, event.event_idx
 	};
 
+	// The accepted event was strung once for all pollers; the handlers can
+	// splice it rather than stringify it again.
+	const scope_restore their_event_source
+	{
+		data.event_source, true
+	};
+
 	const scope_restore client_txnid
 	{
 		data.client_txnid, event.client_txnid
@@ -37,17 +37,43 @@ namespace ircd::m::sync
 namespace ircd::m::sync::longpoll
 {
 	struct accepted;
+	struct poller;
 
 	size_t polling {0};
-	std::deque<accepted> queue;
-	ctx::dock dock;
+	std::multimap<string_view, poller *> rooms;
+	std::multimap<string_view, poller *> users;
+
+	extern ircd::stats::item stats_events;
+	extern ircd::stats::item stats_broadcasts;
+	extern ircd::stats::item stats_wakeups;
+	extern ircd::stats::item stats_hits;
 
 	static bool handle(data &, const args &, const accepted &, const mutable_buffer &scratch);
 	static bool poll(data &, const args &);
+	static void wake(poller &, const std::shared_ptr<const accepted> &);
 	static void handle_notify(const m::event &, m::vm::eval &);
 	extern m::hookfn<m::vm::eval &> notified;
 }
 
+/// A polling client registered in the rooms and users indexes. Accepted
+/// events are only delivered to the pollers found under the event's room_id
+/// (or under the state_key for membership events), so a poller wakes for
+/// events which are likely relevant to it rather than for every event.
+struct ircd::m::sync::longpoll::poller
+{
+	sync::data &data;
+	ctx::dock dock;
+	std::deque<std::shared_ptr<const accepted>> queue;
+	std::vector<std::string> room_ids;
+	std::vector<decltype(rooms)::iterator> room_its;
+	decltype(users)::iterator user_it;
+
+	poller(sync::data &);
+	poller(poller &&) = delete;
+	poller(const poller &) = delete;
+	~poller() noexcept;
+};
+
 struct ircd::m::sync::longpoll::accepted
 :m::event
 {
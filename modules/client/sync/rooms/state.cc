@@ -10,6 +10,8 @@
 
 namespace ircd::m::sync
 {
+	static string_view room_state_fragment(const mutable_buffer &, const m::event &, const m::event::idx &prev);
+	static void room_state_append_fragment(data &, json::stack::array &, const json::object &, const m::event::idx &);
 	static void room_state_append(data &, json::stack::array &, const m::event &, const m::event::idx &);
 
 	static bool room_state_phased_events(data &);
@@ -22,8 +24,14 @@ namespace ircd::m::sync
 	static bool room_invite_state_linear(data &);
 	static bool room_state_linear(data &);
 
+	static void room_state_snapshot(const m::event &, m::vm::eval &);
+	static bool redacted(const m::event::idx &);
+
 	extern const event::keys::include _default_keys;
 	extern event::fetch::opts _default_fopts;
+	extern conf::item<bool> snapshot_enable;
+	extern conf::item<bool> snapshot_writeback;
+	extern m::hookfn<m::vm::eval &> room_state_snapshot_hook;
 
 	extern item room_invite_state;
 	extern item room_state;
@@ -77,6 +85,144 @@ ircd::m::sync::_default_fopts
 	_default_keys
 };
 
+/// Polylog sync of room state splices pre-rendered events from the
+/// dbs::room_sync snapshot when they are still current.
+decltype(ircd::m::sync::snapshot_enable)
+ircd::m::sync::snapshot_enable
+{
+	{ "name",     "ircd.client.sync.rooms.state.snapshot.enable" },
+	{ "default",  true                                           },
+};
+
+/// Polylog sync writes back any state it had to render because the snapshot
+/// was missing or stale, so the next sync for the room can use it.
+decltype(ircd::m::sync::snapshot_writeback)
+ircd::m::sync::snapshot_writeback
+{
+	{ "name",     "ircd.client.sync.rooms.state.snapshot.writeback" },
+	{ "default",  true                                              },
+};
+
+decltype(ircd::m::sync::room_state_snapshot_hook)
+ircd::m::sync::room_state_snapshot_hook
+{
+	room_state_snapshot,
+	{
+		{ "_site",  "vm.post" },
+	}
+};
+
+/// Maintains the room_sync snapshot in the same transaction as the event.
+/// New state replaces its fragment; a redaction of a state event removes
+/// its fragment so it is rendered from the event next time.
+void
+ircd::m::sync::room_state_snapshot(const m::event &event,
+                                   m::vm::eval &eval)
+{
+	if(!snapshot_enable)
+		return;
+
+	assert(eval.opts);
+	if(!eval.txn || !eval.opts->present)
+		return;
+
+	const auto &room_id
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	if(!room_id)
+		return;
+
+	char keybuf[dbs::ROOM_STATE_KEY_MAX_SIZE];
+	if(json::get<"type"_>(event) == "m.room.redaction")
+	{
+		const auto target_idx
+		{
+			m::index(json::get<"redacts"_>(event), std::nothrow)
+		};
+
+		const m::event::fetch target
+		{
+			target_idx, std::nothrow, _default_fopts
+		};
+
+		if(!target.valid || !defined(json::get<"state_key"_>(target)))
+			return;
+
+		db::txn::append
+		{
+			*eval.txn, dbs::room_sync,
+			{
+				db::op::DELETE,
+				dbs::room_state_key(keybuf, room_id, at<"type"_>(target), at<"state_key"_>(target)),
+			}
+		};
+
+		return;
+	}
+
+	if(!defined(json::get<"state_key"_>(event)))
+		return;
+
+	// The present state table has not been committed yet; it still points
+	// at the state this event replaces.
+	const m::room room
+	{
+		room_id
+	};
+
+	const m::room::state state
+	{
+		room
+	};
+
+	const auto prev_idx
+	{
+		state.get(std::nothrow, at<"type"_>(event), at<"state_key"_>(event))
+	};
+
+	const json::strung strung
+	{
+		event
+	};
+
+	const m::event essential
+	{
+		json::object{strung}, _default_keys
+	};
+
+	const unique_buffer<mutable_buffer> buf
+	{
+		event::MAX_SIZE * 2 + sizeof(event::idx)
+	};
+
+	const string_view fragment
+	{
+		room_state_fragment(mutable_buffer{buf} + sizeof(event::idx), essential, prev_idx)
+	};
+
+	db::txn::append
+	{
+		*eval.txn, dbs::room_sync,
+		{
+			db::op::SET,
+			dbs::room_state_key(keybuf, room_id, at<"type"_>(event), at<"state_key"_>(event)),
+			dbs::room_sync_val(buf, eval.sequence, fragment),
+		}
+	};
+
+	db::txn::append
+	{
+		*eval.txn, dbs::room_sync,
+		{
+			db::op::SET,
+			dbs::room_state_key(keybuf, room_id, string_view{}),
+			byte_view<string_view>(eval.sequence),
+		}
+	};
+}
+
 bool
 ircd::m::sync::room_state_linear(data &data)
 {
@@ -192,9 +338,34 @@ ircd::m::sync::room_state_polylog_events(data &data)
 		*data.out, "events"
 	};
 
+	// The snapshot head exists once the room has been snapshotted at all;
+	// without it there's nothing to merge with.
+	char keybuf[dbs::ROOM_STATE_KEY_MAX_SIZE];
+	const bool snapshot
+	{
+		snapshot_enable &&
+		db::has(dbs::room_sync, dbs::room_state_key(keybuf, room.room_id, string_view{}))
+	};
+
+	std::unique_ptr<db::txn> txn
+	{
+		snapshot_writeback?
+			std::make_unique<db::txn>(*dbs::events):
+			nullptr
+	};
+
+	// Fragment buffers are reused by the renderings of this request; only as
+	// many are allocated as are rendering concurrently.
+	std::vector<unique_buffer<mutable_buffer>> bufs;
+
+	// Rows written back, to be checked against redactions once committed.
+	std::vector<std::pair<event::idx, std::string>> written;
+
 	bool ret{false};
 	ctx::mutex mutex;
-	const event::closure_idx each_idx{[&data, &array, &mutex, &ret]
+	event::idx head{0};
+	size_t hits(0), rendered(0);
+	const event::closure_idx each_idx{[&data, &array, &mutex, &ret, &txn, &head, &rendered, &bufs, &written]
 	(const m::event::idx event_idx)
 	{
 		const event::fetch event
@@ -216,9 +387,59 @@ ircd::m::sync::room_state_polylog_events(data &data)
 			return;
 		}
 
+		unique_buffer<mutable_buffer> buf;
+		if(!bufs.empty())
+		{
+			buf = std::move(bufs.back());
+			bufs.pop_back();
+		}
+		else buf = unique_buffer<mutable_buffer>
+		{
+			event::MAX_SIZE * 2 + sizeof(event::idx)
+		};
+
+		const unwind release{[&bufs, &buf]
+		{
+			bufs.emplace_back(std::move(buf));
+		}};
+
+		const string_view fragment
+		{
+			room_state_fragment(mutable_buffer{buf} + sizeof(event::idx), event, room::state::prev(event_idx))
+		};
+
+		// A redacted event is rendered but never written back.
+		const bool writeback
+		{
+			txn && !redacted(event_idx)
+		};
+
 		const std::lock_guard lock{mutex};
-		room_state_append(data, array, event, event_idx);
+		room_state_append_fragment(data, array, fragment, event_idx);
 		ret = true;
+		++rendered;
+
+		if(!writeback)
+			return;
+
+		char keybuf[dbs::ROOM_STATE_KEY_MAX_SIZE];
+		const string_view key
+		{
+			dbs::room_state_key(keybuf, data.room->room_id, at<"type"_>(event), at<"state_key"_>(event))
+		};
+
+		db::txn::append
+		{
+			*txn, dbs::room_sync,
+			{
+				db::op::SET,
+				key,
+				dbs::room_sync_val(buf, event_idx, fragment),
+			}
+		};
+
+		written.emplace_back(event_idx, key);
+		head = std::max(head, event_idx);
 	}};
 
 	//TODO: conf
@@ -228,14 +449,99 @@ ircd::m::sync::room_state_polylog_events(data &data)
 		m::sync::pool, md, each_idx
 	};
 
-	state.for_each([&data, &parallel]
-	(const m::event::idx &event_idx)
+	// Both the present state table and the snapshot are ordered by
+	// (type, state_key) so the snapshot is merged in a single pass; entries
+	// are only used if they were rendered from the present event_idx.
+	db::index::const_iterator it
 	{
-		if(apropos(data, event_idx))
-			parallel(event_idx);
+		snapshot?
+			dbs::room_sync.begin(room.room_id):
+			db::index::const_iterator{}
+	};
+
+	state.for_each([&](const string_view &type, const string_view &state_key, const m::event::idx &event_idx)
+	{
+		if(!apropos(data, event_idx))
+			return true;
+
+		for(; snapshot && bool(it); ++it)
+		{
+			const auto key(dbs::room_state_key(it->first));
+			if(std::tie(std::get<0>(key), std::get<1>(key)) >= std::tie(type, state_key))
+				break;
+		}
+
+		if(snapshot && bool(it) && dbs::room_state_key(it->first) == std::make_pair(type, state_key))
+		{
+			const auto &[fragment_idx, fragment]
+			{
+				dbs::room_sync_val(it->second)
+			};
+
+			if(fragment_idx == event_idx)
+			{
+				const std::lock_guard lock{mutex};
+				room_state_append_fragment(data, array, fragment, event_idx);
+				ret = true;
+				++hits;
+				return true;
+			}
+		}
+
+		parallel(event_idx);
+		return true;
 	});
 
 	parallel.wait_done();
+	if(txn && txn->size() && !snapshot)
+		db::txn::append
+		{
+			*txn, dbs::room_sync,
+			{
+				db::op::SET,
+				dbs::room_state_key(keybuf, room.room_id, string_view{}),
+				byte_view<string_view>(head),
+			}
+		};
+
+	if(txn && txn->size())
+		(*txn)();
+
+	// A redaction committed after the check above deleted the row, but may
+	// have done so before the row was written back here; the row is deleted
+	// again. A redaction committed after this point deletes it itself.
+	if(!written.empty())
+	{
+		db::txn undo
+		{
+			*dbs::events
+		};
+
+		for(const auto &[event_idx, key] : written)
+			if(redacted(event_idx))
+				db::txn::append
+				{
+					undo, dbs::room_sync,
+					{
+						db::op::DELETE,
+						key,
+					}
+				};
+
+		if(undo.size())
+			undo();
+	}
+
+	log::debug
+	{
+		log, "request %s room %s state snapshot:%b hits:%zu rendered:%zu",
+		loghead(data),
+		string_view{room.room_id},
+		snapshot,
+		hits,
+		rendered,
+	};
+
 	return ret;
 }
 
@@ -276,6 +582,68 @@ ircd::m::sync::room_state_phased_events(data &data)
 	return ret;
 }
 
+/// Renders the client form of a state event as stored in the snapshot; this
+/// is everything but the unsigned section which depends on the request.
+ircd::string_view
+ircd::m::sync::room_state_fragment(const mutable_buffer &buf,
+                                   const m::event &event,
+                                   const m::event::idx &prev_idx)
+{
+	json::stack out{buf};
+	{
+		json::stack::object top
+		{
+			out
+		};
+
+		top.append(event);
+		if(prev_idx)
+			m::get(std::nothrow, prev_idx, "content", [&top]
+			(const json::object &content)
+			{
+				json::stack::member
+				{
+					top, "prev_content", content
+				};
+			});
+	}
+
+	return out.completed();
+}
+
+bool
+ircd::m::sync::redacted(const m::event::idx &event_idx)
+{
+	const m::event::refs refs
+	{
+		event_idx
+	};
+
+	return refs.count(dbs::ref::M_ROOM_REDACTION);
+}
+
+void
+ircd::m::sync::room_state_append_fragment(data &data,
+                                          json::stack::array &events,
+                                          const json::object &fragment,
+                                          const m::event::idx &event_idx)
+{
+	const m::event event
+	{
+		fragment
+	};
+
+	m::event_append_opts opts;
+	opts.event_idx = &event_idx;
+	opts.user_id = &data.user.user_id;
+	opts.user_room = &data.user_room;
+	opts.query_txnid = false;
+	opts.query_prev_state = false;
+	opts.json_source = true;
+	opts.room_depth = &data.room_depth;
+	m::append(events, event, opts);
+}
+
 void
 ircd::m::sync::room_state_append(data &data,
                                  json::stack::array &events,
@@ -288,5 +656,6 @@ ircd::m::sync::room_state_append(data &data,
 	opts.user_room = &data.user_room;
 	opts.query_txnid = false;
 	opts.room_depth = &data.room_depth;
+	opts.json_source = data.event_source && data.event == &event;
 	m::append(events, event, opts);
 }
@@ -260,5 +260,6 @@ ircd::m::sync::_room_timeline_append(data &data,
 	opts.user_id = &data.user.user_id;
 	opts.user_room = &data.user_room;
 	opts.room_depth = &data.room_depth;
+	opts.json_source = data.event_source && data.event == &event;
 	m::append(events, event, opts);
 }
@@ -899,6 +899,110 @@ console_cmd__prof__vg__dump(opt &out, const string_view &line)
 	return true;
 }
 
+//
+// json
+//
+
+static size_t
+_json_bench_walk(const string_view &value)
+{
+	size_t ret(1);
+	switch(json::type(value))
+	{
+		case json::OBJECT:
+			for(const auto &member : json::object{value})
+				ret += _json_bench_walk(member.second);
+			break;
+
+		case json::ARRAY:
+			for(const auto &element : json::array{value})
+				ret += _json_bench_walk(element);
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+bool
+console_cmd__json__bench(opt &out, const string_view &line)
+{
+	const params param{line, " ",
+	{
+		"limit", "rounds"
+	}};
+
+	const size_t limit
+	{
+		param.at<size_t>("limit", 16384UL)
+	};
+
+	const size_t rounds
+	{
+		param.at<size_t>("rounds", 4UL)
+	};
+
+	// The corpus is the most recent events in the database.
+	static const db::gopts gopts
+	{
+		db::get::SCAN
+	};
+
+	std::vector<std::string> corpus;
+	corpus.reserve(limit);
+	size_t bytes(0);
+	for(auto it(m::dbs::event_json.rbegin(gopts)); it && corpus.size() < limit; ++it)
+	{
+		corpus.emplace_back(it->second);
+		bytes += size(corpus.back());
+	}
+
+	const unwind restore{[enable(conf::get("ircd.json.scan.enable"))]
+	{
+		conf::set(std::nothrow, "ircd.json.scan.enable", enable);
+	}};
+
+	const auto run{[&corpus, &rounds]
+	(const bool &scan, size_t &values)
+	{
+		conf::set("ircd.json.scan.enable", scan? "true"_sv : "false"_sv);
+		values = 0;
+		ircd::timer timer;
+		for(size_t i(0); i < rounds; ++i)
+			for(const auto &event : corpus)
+				values += _json_bench_walk(event);
+
+		return timer.at<nanoseconds>();
+	}};
+
+	size_t values[2];
+	const nanoseconds grammar(run(false, values[0]));
+	const nanoseconds scanner(run(true, values[1]));
+
+	const auto rate{[&bytes, &rounds](const nanoseconds &t)
+	{
+		const long double secs(t.count() / 1'000'000'000.0L);
+		return secs > 0.0L? (bytes * rounds / secs) / (1024 * 1024) : 0.0L;
+	}};
+
+	char pbuf[2][48];
+	out << "events:     " << corpus.size() << std::endl
+	    << "bytes:      " << pretty(pbuf[0], iec(bytes)) << std::endl
+	    << "rounds:     " << rounds << std::endl
+	    << "values:     " << values[0] << " " << values[1] << std::endl
+	    << std::endl
+	    << std::setw(12) << std::left << "grammar:"
+	    << std::setw(16) << std::left << pretty(pbuf[0], grammar, true)
+	    << rate(grammar) << " MiB/s" << std::endl
+	    << std::setw(12) << std::left << json::scan_isa << ':'
+	    << std::setw(16) << std::left << pretty(pbuf[1], scanner, true)
+	    << rate(scanner) << " MiB/s" << std::endl;
+
+	return true;
+}
+
 //
 // env
 //
@@ -1008,23 +1112,45 @@ console_cmd__ios(opt &out, const string_view &line)
 }
 
 //
-// aio
+// stats
 //
 
 bool
-console_cmd__aio(opt &out, const string_view &line)
+console_cmd__stats(opt &out, const string_view &line)
 {
-	if(!fs::aio::system)
-		throw error
-		{
-			"AIO is not available."
-		};
+	const params param{line, " ",
+	{
+		"prefix"
+	}};
 
-	const auto &s
+	const string_view &prefix
 	{
-		fs::aio::stats
+		param["prefix"]
 	};
 
+	for(const auto &[name, item] : stats::items)
+	{
+		if(prefix && !startswith(name, prefix))
+			continue;
+
+		assert(item);
+		out << std::left << std::setw(48) << name
+		    << " " << std::right << std::setw(20) << int64_t(stats::get(*item))
+		    << std::endl;
+	}
+
+	return true;
+}
+
+//
+// aio
+//
+
+template<class S>
+static void
+_print_aio_stats(opt &out,
+                 const S &s)
+{
 	out << std::setw(18) << std::left << "requests"
 	    << std::setw(9) << std::right << s.requests
 	    << "   " << pretty(iec(s.bytes_requests))
@@ -1080,9 +1206,12 @@ console_cmd__aio(opt &out, const string_view &line)
 	    << std::endl;
 
 	out << std::setw(18) << std::left << "writes cur"
-	    << std::setw(9) << std::right << s.cur_writes
-	    << "   " << pretty(iec(s.cur_bytes_write))
-	    << std::endl;
+	    << std::setw(9) << std::right << s.cur_writes;
+
+	if constexpr(std::is_same<S, struct fs::aio::stats>())
+		out << "   " << pretty(iec(s.cur_bytes_write));
+
+	out << std::endl;
 
 	out << std::setw(18) << std::left << "writes avg"
 	    << std::setw(9) << std::right << "-"
@@ -1109,6 +1238,11 @@ console_cmd__aio(opt &out, const string_view &line)
 	    << std::setw(9) << std::right << s.stalls
 	    << std::endl;
 
+	if constexpr(std::is_same<S, struct fs::iou::stats>())
+		out << std::setw(18) << std::left << "retries"
+		    << std::setw(9) << std::right << s.retries
+		    << std::endl;
+
 	out << std::setw(18) << std::left << "errors"
 	    << std::setw(9) << std::right << s.errors
 	    << "   " << pretty(iec(s.bytes_errors))
@@ -1118,6 +1252,38 @@ console_cmd__aio(opt &out, const string_view &line)
 	    << std::setw(9) << std::right << s.cancel
 	    << "   " << pretty(iec(s.bytes_cancel))
 	    << std::endl;
+}
+
+bool
+console_cmd__aio(opt &out, const string_view &line)
+{
+	if(!fs::aio::system && !fs::iou::system)
+		throw error
+		{
+			"AIO is not available."
+		};
+
+	// io_uring is preferred at runtime; both are listed if both are up.
+	const bool both
+	{
+		fs::aio::system && fs::iou::system
+	};
+
+	if(fs::iou::system)
+	{
+		if(both)
+			out << "io_uring" << std::endl;
+
+		_print_aio_stats(out, fs::iou::stats);
+	}
+
+	if(fs::aio::system)
+	{
+		if(both)
+			out << std::endl << "aio" << std::endl;
+
+		_print_aio_stats(out, fs::aio::stats);
+	}
 
 	return true;
 }
@@ -2599,6 +2765,8 @@ try
 	    << " "
 	    << std::setw(7) << "PCT"
 	    << " "
+	    << std::setw(7) << "HIT"
+	    << " "
 	    << std::setw(9) << "HITS"
 	    << " "
 	    << std::setw(9) << "MISSES"
@@ -2623,12 +2791,20 @@ try
 			s.capacity > 0.0? (double(s.usage) / double(s.capacity)) : 0.0L
 		};
 
+		const auto hit_pct
+		{
+			s.hits + s.misses > 0? (double(s.hits) / double(s.hits + s.misses)) : 0.0L
+		};
+
 		out << std::setw(32) << std::left << column_name
 		    << std::right
 		    << " "
 		    << std::setw(6) << std::right << std::fixed << std::setprecision(2) << (pct * 100)
 		    << '%'
 		    << " "
+		    << std::setw(6) << std::right << std::fixed << std::setprecision(2) << (hit_pct * 100)
+		    << '%'
+		    << " "
 		    << std::setw(9) << s.hits
 		    << " "
 		    << std::setw(9) << s.misses
@@ -5822,9 +5998,14 @@ console_cmd__events(opt &out, const string_view &line)
 		return --limit > 0;
 	}};
 
+	static const m::event::fetch::opts fopts
+	{
+		{ db::get::SCAN }
+	};
+
 	const m::events::range range
 	{
-		uint64_t(start), uint64_t(stop)
+		uint64_t(start), uint64_t(stop), &fopts
 	};
 
 	m::events::for_each(range, closure);
@@ -6013,9 +6194,19 @@ console_cmd__events__dump(opt &out, const string_view &line)
 		size_t(events_dump_buffer_size)
 	};
 
+	static const m::event::fetch::opts fopts
+	{
+		{ db::get::SCAN }
+	};
+
+	const m::events::range range
+	{
+		m::event::idx{0}, m::event::idx(-1), &fopts
+	};
+
 	char *pos{data(buf)};
 	size_t foff{0}, ecount{0}, acount{0}, errcount{0};
-	m::events::for_each(m::event::idx{0}, [&]
+	m::events::for_each(range, [&]
 	(const m::event::idx &seq, const m::event &event)
 	{
 		const auto remain
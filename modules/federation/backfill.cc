@@ -96,9 +96,16 @@ get__backfill(client &client,
 		calc_limit(request)
 	};
 
+	// The history requested is rarely read by anything else; the pass
+	// shouldn't displace the hot set from the block cache.
+	static const m::event::fetch::opts fopts
+	{
+		{ db::get::SCAN }
+	};
+
 	m::room::messages it
 	{
-		room_id, event_id
+		room_id, event_id, &fopts
 	};
 
 	resource::response::chunked response
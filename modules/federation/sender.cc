@@ -13,8 +13,9 @@
 
 std::list<txn> txns;
 std::map<std::string, node, std::less<>> nodes;
+std::set<std::pair<steady_point, node *>> sched;
 
-void remove_node(const node &);
+static node *find_node(const string_view &origin);
 static void recv_timeout(txn &, node &);
 static void recv_timeouts();
 static bool recv_handle(txn &, node &);
@@ -25,6 +26,10 @@ ctx::dock recv_action;
 static void send(const m::event &, const m::user::id &user_id);
 static void send(const m::event &, const m::room::id &room_id);
 static void send(const m::event &);
+static void fanout(db::txn &, const m::event::idx &, const m::event &, std::set<std::string, std::less<>> &);
+static void enqueue(const vector_view<const m::event::idx> &);
+static void recover();
+static void dispatch_nodes();
 static void send_worker();
 
 static void handle_notify(const m::event &, m::vm::eval &);
@@ -54,9 +59,96 @@ IRCD_MODULE
 	}
 };
 
+conf::item<size_t>
+txn_pdus_max
+{
+	{ "name",     "ircd.federation.sender.txn.pdus.max" },
+	{ "default",  50L                                   },
+};
+
+conf::item<size_t>
+txn_edus_max
+{
+	{ "name",     "ircd.federation.sender.txn.edus.max" },
+	{ "default",  100L                                  },
+};
+
+conf::item<size_t>
+txn_size_max
+{
+	{ "name",     "ircd.federation.sender.txn.size.max" },
+	{ "default",  long(1_MiB)                           },
+};
+
+conf::item<size_t>
+txn_concurrent_max
+{
+	{ "name",     "ircd.federation.sender.txn.concurrent.max" },
+	{ "default",  64L                                         },
+};
+
+conf::item<size_t>
+queue_edus_max
+{
+	{ "name",     "ircd.federation.sender.queue.edus.max" },
+	{ "default",  1024L                                   },
+};
+
+conf::item<milliseconds>
+coalesce
+{
+	{ "name",     "ircd.federation.sender.coalesce" },
+	{ "default",  50L                               },
+};
+
+conf::item<seconds>
+backoff_min
+{
+	{ "name",     "ircd.federation.sender.backoff.min" },
+	{ "default",  10L                                  },
+};
+
+conf::item<seconds>
+backoff_max
+{
+	{ "name",     "ircd.federation.sender.backoff.max" },
+	{ "default",  long(60 * 60 * 6)                    },
+};
+
+/// After this many consecutive failures nothing more is queued for the
+/// server until its backoff expires and an attempt succeeds.
+conf::item<size_t>
+backoff_skip
+{
+	{ "name",     "ircd.federation.sender.backoff.skip" },
+	{ "default",  4L                                    },
+};
+
+conf::item<size_t>
+recover_batch_max
+{
+	{ "name",     "ircd.federation.sender.recover.batch.max" },
+	{ "default",  64L                                        },
+};
+
+/// EDUs notified for sending; these are not persisted.
 std::deque<std::string>
 notified_queue;
 
+/// PDUs notified for sending by their index; these are entered into the
+/// durable queue of each server in the room by the worker.
+std::deque<m::event::idx>
+notified_pdus;
+
+/// PDUs which could not be read when they were to be entered into the
+/// queues; nested evals notify before their transaction is committed at the
+/// stack base. These are retried until found or retired.
+std::deque<m::event::idx>
+deferred_pdus;
+
+steady_point
+deferred_due;
+
 ctx::dock
 notified_dock;
 
@@ -80,19 +172,88 @@ handle_notify(const m::event &event,
 	if(!eval.opts->notify_servers)
 		return;
 
-	notified_queue.emplace_back(json::strung{event});
+	if(json::get<"event_id"_>(event))
+	{
+		assert(eval.sequence);
+		notified_pdus.emplace_back(eval.sequence);
+	}
+	else notified_queue.emplace_back(json::strung{event});
+
 	notified_dock.notify_all();
 }
 
 void
 send_worker()
 {
+	try
+	{
+		recover();
+	}
+	catch(const std::exception &e)
+	{
+		log::error
+		{
+			"sender recovery: %s", e.what()
+		};
+	}
+
 	while(1) try
 	{
-		notified_dock.wait([]
+		const auto dispatchable{[]
 		{
-			return !notified_queue.empty();
-		});
+			return !sched.empty()
+			&& txns.size() < size_t(txn_concurrent_max)
+			&& begin(sched)->first <= now<steady_point>();
+		}};
+
+		const auto retriable{[]
+		{
+			return !deferred_pdus.empty() && deferred_due <= now<steady_point>();
+		}};
+
+		const auto pred{[&dispatchable, &retriable]
+		{
+			return !notified_queue.empty() || !notified_pdus.empty() || dispatchable() || retriable();
+		}};
+
+		// Sleep until something is notified or the next node in the
+		// schedule or the deferred PDUs come due; a freed transaction slot
+		// also notifies.
+		const bool scheduled
+		{
+			!sched.empty() && txns.size() < size_t(txn_concurrent_max)
+		};
+
+		if(!scheduled && deferred_pdus.empty())
+			notified_dock.wait(pred);
+		else if(!scheduled)
+			notified_dock.wait_until(deferred_due, pred);
+		else if(deferred_pdus.empty())
+			notified_dock.wait_until(begin(sched)->first, pred);
+		else
+			notified_dock.wait_until(std::min(begin(sched)->first, deferred_due), pred);
+
+		dispatch_nodes();
+
+		if(retriable())
+		{
+			notified_pdus.insert(end(notified_pdus), begin(deferred_pdus), end(deferred_pdus));
+			deferred_pdus.clear();
+		}
+
+		if(!notified_pdus.empty())
+		{
+			const std::vector<m::event::idx> pdus
+			{
+				begin(notified_pdus), end(notified_pdus)
+			};
+
+			notified_pdus.clear();
+			enqueue(pdus);
+		}
+
+		if(notified_queue.empty())
+			continue;
 
 		const unwind pop{[]
 		{
@@ -149,24 +310,19 @@ send(const m::event &event,
 		if(my_host(origin))
 			return;
 
-		auto it{nodes.lower_bound(origin)};
-		if(it == end(nodes) || it->first != origin)
+		auto *const node
 		{
-			if(server::errmsg(origin))
-				return;
-
-			it = nodes.emplace_hint(it, origin, origin);
-		}
+			find_node(origin)
+		};
 
-		auto &node{it->second};
-		if(node.err)
+		if(!node || node->dead())
 			return;
 
 		if(!unit)
 			unit = std::make_shared<struct unit>(event);
 
-		node.push(unit);
-		node.flush();
+		node->push(unit);
+		node->flush();
 	});
 }
 
@@ -182,17 +338,12 @@ send(const m::event &event,
 	if(my_host(remote))
 		return;
 
-	auto it{nodes.lower_bound(remote)};
-	if(it == end(nodes) || it->first != remote)
+	auto *const node
 	{
-		if(server::errmsg(remote))
-			return;
-
-		it = nodes.emplace_hint(it, remote, remote);
-	}
+		find_node(remote)
+	};
 
-	auto &node{it->second};
-	if(node.err)
+	if(!node || node->dead())
 		return;
 
 	auto unit
@@ -200,48 +351,384 @@ send(const m::event &event,
 		std::make_shared<struct unit>(event)
 	};
 
-	node.push(std::move(unit));
-	node.flush();
+	node->push(std::move(unit));
+	node->flush();
 }
 
+/// Enter PDUs into the durable queue of each server in their room, and
+/// advance the fan-out cursor, in a single transaction. Servers with a
+/// transaction in flight pick these up from the queue when it completes.
+///
+/// The cursor only advances over the leading PDUs which were entered (or
+/// are retired and gone); a PDU which cannot be read yet is deferred and the
+/// cursor is held below it, so it is not lost even across a restart.
+void
+enqueue(const vector_view<const m::event::idx> &pdus_)
+{
+	if(pdus_.empty())
+		return;
+
+	std::vector<m::event::idx> pdus
+	{
+		begin(pdus_), end(pdus_)
+	};
+
+	std::sort(begin(pdus), end(pdus));
+	pdus.erase(std::unique(begin(pdus), end(pdus)), end(pdus));
+
+	std::vector<bool> found(pdus.size(), false);
+	std::set<std::string, std::less<>> origins;
+	db::txn txn
+	{
+		*m::dbs::events
+	};
+
+	m::seek(pdus, [&txn, &origins, &pdus, &found]
+	(const m::event::idx &event_idx, const m::event &event)
+	{
+		const auto it(std::lower_bound(begin(pdus), end(pdus), event_idx));
+		assert(it != end(pdus) && *it == event_idx);
+		found.at(std::distance(begin(pdus), it)) = true;
+		fanout(txn, event_idx, event, origins);
+		return true;
+	});
+
+	bool held(false);
+	m::event::idx cursor{0};
+	for(size_t i(0); i < pdus.size(); ++i)
+	{
+		const bool resolved
+		{
+			found[i] || pdus[i] <= m::vm::sequence::retired
+		};
+
+		if(!resolved)
+		{
+			deferred_pdus.emplace_back(pdus[i]);
+			deferred_due = now<steady_point>() + milliseconds(coalesce);
+			held = true;
+		}
+		else if(!held)
+			cursor = pdus[i];
+	}
+
+	// PDUs deferred by an earlier pass also hold the cursor below them.
+	if(!deferred_pdus.empty())
+		cursor = std::min(cursor, *std::min_element(begin(deferred_pdus), end(deferred_pdus)) - 1);
+
+	// Evals are notified out of order; a lower idx still being evaluated may
+	// not have been notified yet. Recovery re-enters anything past the cursor
+	// so it never passes the retired sequence.
+	cursor = std::min(cursor, m::event::idx(m::vm::sequence::retired));
+
+	char buf[m::dbs::NODE_SEND_KEY_MAX_SIZE];
+	if(cursor)
+		db::txn::append
+		{
+			txn, m::dbs::node_send,
+			{
+				db::op::SET,
+				m::dbs::node_send_key(buf, string_view{}),
+				byte_view<string_view>(cursor)
+			}
+		};
+
+	txn();
+	for(const auto &origin : origins)
+		if(auto *const node{find_node(origin)}; node)
+			node->flush();
+}
+
+void
+fanout(db::txn &txn,
+       const m::event::idx &event_idx,
+       const m::event &event,
+       std::set<std::string, std::less<>> &origins)
+{
+	const auto &room_id
+	{
+		json::get<"room_id"_>(event)
+	};
+
+	if(json::get<"depth"_>(event) == json::undefined_number)
+		return;
+
+	if(!valid(m::id::ROOM, room_id))
+		return;
+
+	const m::room room{room_id};
+	const m::room::origins room_origins{room};
+	room_origins.for_each([&txn, &event_idx, &origins]
+	(const string_view &origin)
+	{
+		if(my_host(origin))
+			return;
+
+		// Every server is queued for, including those backing off; the
+		// backoff only delays when the queue is next flushed to them.
+		char buf[m::dbs::NODE_SEND_KEY_MAX_SIZE];
+		db::txn::append
+		{
+			txn, m::dbs::node_send,
+			{
+				db::op::SET,
+				m::dbs::node_send_key(buf, origin, event_idx)
+			}
+		};
+
+		origins.emplace(origin);
+	});
+}
+
+/// Resume after a restart. Our events admitted after the fan-out cursor
+/// missed the queues and are entered now; then a transaction is started for
+/// each server with anything left in its queue.
+void
+recover()
+{
+	char buf[m::dbs::NODE_SEND_KEY_MAX_SIZE];
+	const string_view cursor_key
+	{
+		m::dbs::node_send_key(buf, string_view{})
+	};
+
+	m::event::idx cursor{0};
+	m::dbs::node_send(cursor_key, std::nothrow, [&cursor]
+	(const string_view &value)
+	{
+		cursor = byte_view<m::event::idx>(value);
+	});
+
+	// There is nothing to recover on the first run; start the cursor here.
+	if(!cursor)
+	{
+		const m::event::idx retired
+		{
+			m::vm::sequence::retired
+		};
+
+		db::write(m::dbs::node_send, cursor_key, byte_view<string_view>(retired));
+		return;
+	}
+
+	std::vector<m::event::idx> pdus;
+	pdus.reserve(size_t(recover_batch_max));
+	const m::events::range range
+	{
+		cursor + 1, m::vm::sequence::retired + 1
+	};
+
+	m::events::for_each(range, [&pdus]
+	(const m::event::idx &event_idx, const m::event &event)
+	{
+		if(!my(event) || !json::get<"event_id"_>(event))
+			return true;
+
+		pdus.emplace_back(event_idx);
+		if(pdus.size() >= size_t(recover_batch_max))
+		{
+			enqueue(pdus);
+			pdus.clear();
+		}
+
+		return true;
+	});
+
+	enqueue(pdus);
+
+	// Visit each origin in the queue once, skipping the cursor entry.
+	db::column &column(m::dbs::node_send);
+	for(auto it(column.begin()); bool(it);)
+	{
+		const std::string origin
+		{
+			split(it->first, "\0"_sv).first
+		};
+
+		if(!origin.empty())
+			if(auto *const node{find_node(origin)}; node)
+				node->flush();
+
+		it = column.upper_bound(m::dbs::node_send_key(buf, origin, -1UL));
+	}
+}
+
+/// EDUs are ephemeral; when the queue is over its limit the oldest are
+/// discarded rather than letting an unreachable server accumulate them.
 void
 node::push(std::shared_ptr<unit> su)
 {
+	assert(su->type == unit::EDU);
 	q.emplace_back(std::move(su));
+	while(q.size() > size_t(queue_edus_max))
+		q.pop_front();
 }
 
+/// Servers past the skip threshold of consecutive failures are considered
+/// dead until their backoff expires.
 bool
-node::flush()
-try
+node::dead()
+const
 {
-	if(q.empty())
-		return true;
+	return attempts >= size_t(backoff_skip) && now<steady_point>() < ready;
+}
 
+/// Request a transaction. Unless now is true the node waits out the
+/// coalescing window so units arriving close together share a transaction;
+/// a full batch of EDUs is sent without waiting. Either way the node is not
+/// sent to before its backoff expires. Nodes with a transaction in flight
+/// are flushed again when it completes.
+bool
+node::flush(const bool &now)
+{
 	if(curtxn)
 		return true;
 
-	size_t pdus{0}, edus{0};
-	for(const auto &unit : q) switch(unit->type)
+	const auto cur
 	{
-		case unit::PDU:   ++pdus;  break;
-		case unit::EDU:   ++edus;  break;
-		default:                   break;
+		ircd::now<steady_point>()
+	};
+
+	const bool full
+	{
+		now || q.size() >= size_t(txn_edus_max)
+	};
+
+	const auto when
+	{
+		std::max(ready, full? cur : cur + milliseconds(coalesce))
+	};
+
+	if(due == steady_point{} || when < due)
+		schedule(when);
+
+	return true;
+}
+
+void
+node::schedule(const steady_point &when)
+{
+	if(due != steady_point{})
+		sched.erase({due, this});
+
+	due = when;
+	if(due != steady_point{})
+	{
+		sched.emplace(due, this);
+		notified_dock.notify_all();
 	}
+}
+
+/// Start transactions for the nodes which have come due, up to the limit
+/// on concurrent transactions; the rest remain scheduled until a slot is
+/// released.
+void
+dispatch_nodes()
+{
+	const auto cur
+	{
+		now<steady_point>()
+	};
 
-	size_t pc(0), ec(0);
-	std::vector<json::value> units(pdus + edus);
-	for(const auto &unit : q) switch(unit->type)
+	while(!sched.empty() && txns.size() < size_t(txn_concurrent_max))
 	{
-		case unit::PDU:
-			units.at(pc++) = string_view{unit->s};
+		const auto it(begin(sched));
+		if(it->first > cur)
 			break;
 
-		case unit::EDU:
-			units.at(pdus + ec++) = string_view{unit->s};
+		auto &node(*it->second);
+		node.schedule(steady_point{});
+		node.transmit();
+	}
+}
+
+/// Assemble the next transaction from the front of the durable queue and
+/// any EDUs held in memory. PDUs are packed in queue order followed by EDUs
+/// up to the unit limits of a transaction and its size limit; at least one
+/// unit is always taken. Only one transaction is in flight at a time.
+bool
+node::transmit()
+try
+{
+	if(curtxn)
+		return true;
+
+	assert(inflight.empty());
+	char buf[m::dbs::NODE_SEND_KEY_MAX_SIZE];
+	auto it
+	{
+		m::dbs::node_send.begin(m::dbs::node_send_key(buf, origin()))
+	};
+
+	std::vector<m::event::idx> queued;
+	queued.reserve(size_t(txn_pdus_max));
+	for(; bool(it) && queued.size() < size_t(txn_pdus_max); ++it)
+		queued.emplace_back(m::dbs::node_send_key(it->first));
+
+	if(queued.empty() && q.empty())
+		return true;
+
+	std::vector<std::pair<db::column *, string_view>> ops(queued.size());
+	for(size_t i(0); i < queued.size(); ++i)
+		ops[i] = { &m::dbs::event_json, m::event::fetch::key(&queued[i]) };
+
+	std::vector<bool> found;
+	const std::vector<std::string> pdu
+	{
+		db::read(ops, found)
+	};
+
+	size_t size(0), pc(0), ec(0);
+	const auto fits{[&size, &pc, &ec]
+	(const size_t &len)
+	{
+		return (!pc && !ec) || size + len + 1 <= size_t(txn_size_max);
+	}};
+
+	std::vector<json::value> units(queued.size() + std::min(q.size(), size_t(txn_edus_max)));
+	for(size_t i(0); i < queued.size(); ++i)
+	{
+		// An event which isn't found but has been retired is gone; it is
+		// dropped from the queue with the rest. Otherwise it may still be
+		// committing and this transaction ends before it.
+		if(!found[i] && queued[i] > m::vm::sequence::retired)
 			break;
 
-		default:
+		if(found[i] && !fits(pdu[i].size()))
 			break;
+
+		inflight.emplace_back(queued[i]);
+		if(!found[i])
+			continue;
+
+		units.at(pc++) = string_view{pdu[i]};
+		size += pdu[i].size() + 1;
+	}
+
+	const size_t pdus
+	{
+		queued.size()
+	};
+
+	for(const auto &unit : q)
+	{
+		if(ec >= size_t(txn_edus_max) || !fits(unit->s.size()))
+			break;
+
+		units.at(pdus + ec++) = string_view{unit->s};
+		size += unit->s.size() + 1;
+	}
+
+	// Everything taken was gone; it is dropped from the queue and the rest
+	// of the queue is transmitted next.
+	if(!pc && !ec)
+	{
+		const bool dropped(!inflight.empty());
+		ack();
+		if(dropped)
+			flush(true);
+
+		return true;
 	}
 
 	m::v1::send::opts opts;
@@ -266,7 +753,7 @@ try
 	txns.emplace_back(*this, std::move(content), std::move(opts));
 	const unwind::nominal::assertion na;
 	curtxn = &txns.back();
-	q.clear();
+	q.erase(begin(q), begin(q) + ec);
 	recv_action.notify_one();
 	return true;
 }
@@ -274,13 +761,76 @@ catch(const std::exception &e)
 {
 	log::error
 	{
-		"flush error to %s :%s", string_view{id}, e.what()
+		"transmit error to %s :%s", string_view{id}, e.what()
 	};
 
-	err = true;
+	failed();
 	return false;
 }
 
+/// The transaction failed; its PDUs remain in the queue to be retried after
+/// a jittered exponential backoff.
+void
+node::failed()
+{
+	err = false;
+	inflight.clear();
+	++attempts;
+
+	const auto exp
+	{
+		std::min(attempts - 1, 20U)
+	};
+
+	const milliseconds max
+	{
+		std::min(milliseconds(seconds(backoff_max)), milliseconds(seconds(backoff_min)) * (1L << exp))
+	};
+
+	const milliseconds delay
+	{
+		long(max.count() / 2 + rand::integer(0, max.count() / 2))
+	};
+
+	ready = now<steady_point>() + delay;
+	log::dwarning
+	{
+		"Backoff %s after %u failures for %ld ms",
+		string_view{id},
+		attempts,
+		delay.count()
+	};
+
+	schedule(ready);
+}
+
+/// The server accepted the transaction; its PDUs leave the queue.
+void
+node::ack()
+{
+	if(inflight.empty())
+		return;
+
+	db::txn txn
+	{
+		*m::dbs::events
+	};
+
+	char buf[m::dbs::NODE_SEND_KEY_MAX_SIZE];
+	for(const auto &event_idx : inflight)
+		db::txn::append
+		{
+			txn, m::dbs::node_send,
+			{
+				db::op::DELETE,
+				m::dbs::node_send_key(buf, origin(), event_idx)
+			}
+		};
+
+	txn();
+	inflight.clear();
+}
+
 void
 recv_worker()
 {
@@ -333,14 +883,14 @@ try
 
 	node.curtxn = nullptr;
 	txns.erase(it);
+	notified_dock.notify_all();
 
-	if(node.err)
-		return remove_node(node);
-
-	if(!ret)
-		return;
+	if(!ret || node.err)
+		return node.failed();
 
-	node.flush();
+	node.attempts = 0;
+	node.ack();
+	node.flush(true);
 }
 catch(const std::exception &e)
 {
@@ -459,14 +1009,19 @@ recv_timeout(txn &txn,
 	node.err = true;
 }
 
-void
-remove_node(const node &node)
+/// Find or create the node for an origin; null if the origin has a cached
+/// error and no node yet. Existing nodes carry their own backoff state.
+node *
+find_node(const string_view &origin)
 {
-	const auto it
+	auto it{nodes.lower_bound(origin)};
+	if(it == end(nodes) || it->first != origin)
 	{
-		nodes.find(node.origin())
-	};
+		if(server::errmsg(origin))
+			return nullptr;
+
+		it = nodes.emplace_hint(it, origin, origin);
+	}
 
-	assert(it != end(nodes));
-	nodes.erase(it);
+	return &it->second;
 }
@@ -71,21 +71,37 @@ struct txndata
 	{}
 };
 
+/// PDUs for the node are not held here; they are queued by reference in the
+/// m::dbs::node_send column and read back when a transaction is assembled.
+/// Only EDUs, which are not persisted, are queued in memory.
+///
+/// Transactions are not sent directly by flush(); the node is entered into
+/// the schedule to be dispatched by the worker after the coalescing window,
+/// or after its backoff when previous attempts failed.
 struct node
 {
 	std::deque<std::shared_ptr<unit>> q;
+	std::vector<m::event::idx> inflight;
 	m::node::id::buf id;
 	m::node::room room;
 	server::request::opts sopts;
 	txn *curtxn {nullptr};
 	bool err {false};
+	uint32_t attempts {0};        // consecutive failures
+	steady_point ready;           // not sent to before this point
+	steady_point due;             // position in schedule; zero if unscheduled
 
 	string_view origin() const
 	{
 		return id.host();
 	};
 
-	bool flush();
+	bool dead() const;
+	void schedule(const steady_point &);
+	bool flush(const bool &now = false);
+	bool transmit();
+	void failed();
+	void ack();
 	void push(std::shared_ptr<unit>);
 
 	node(const string_view &origin)
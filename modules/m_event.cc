@@ -511,9 +511,12 @@ ircd::m::append(json::stack::object &object,
 		}
 	}
 
-	object.append(event);
+	if(opts.json_source && event.source)
+		object.splice(event.source);
+	else
+		object.append(event);
 
-	if(json::get<"state_key"_>(event) && has_event_idx)
+	if(json::get<"state_key"_>(event) && has_event_idx && opts.query_prev_state)
 	{
 		const auto prev_idx
 		{
@@ -626,9 +629,14 @@ ircd::m::event::refs::rebuild()
 		dbs::event_json
 	};
 
+	static const db::gopts gopts
+	{
+		db::get::NO_CACHE, db::get::SCAN
+	};
+
 	auto it
 	{
-		column.begin()
+		column.begin(gopts)
 	};
 
 	ctx::dock dock;
@@ -1443,16 +1451,21 @@ ircd::m::essential(m::event event,
 	}
 	else if(type == "m.room.power_levels")
 	{
+		const json::object::index<> index
+		{
+			content
+		};
+
 		content = json::stringify(essential, json::members
 		{
-			{ "ban", content.at("ban")                       },
-			{ "events", content.at("events")                 },
-			{ "events_default", content.at("events_default") },
-			{ "kick", content.at("kick")                     },
-			{ "redact", content.at("redact")                 },
-			{ "state_default", content.at("state_default")   },
-			{ "users", content.at("users")                   },
-			{ "users_default", content.at("users_default")   },
+			{ "ban", index.at("ban")                         },
+			{ "events", index.at("events")                   },
+			{ "events_default", index.at("events_default")   },
+			{ "kick", index.at("kick")                       },
+			{ "redact", index.at("redact")                   },
+			{ "state_default", index.at("state_default")     },
+			{ "users", index.at("users")                     },
+			{ "users_default", index.at("users_default")     },
 		});
 	}
 	else if(type == "m.room.redaction")
@@ -266,7 +266,7 @@ ircd::m::room::head::rebuild(const head &head)
 
 	static const m::event::fetch::opts fopts
 	{
-		{ db::get::NO_CACHE }
+		{ db::get::NO_CACHE, db::get::SCAN }
 	};
 
 	m::room::messages it
@@ -601,7 +601,7 @@ ircd::m::room::state::rebuild_present(const state &state)
 
 	static const m::event::fetch::opts fopts
 	{
-		{ db::get::NO_CACHE }
+		{ db::get::NO_CACHE, db::get::SCAN }
 	};
 
 	const m::room room
@@ -656,7 +656,7 @@ ircd::m::room::state::rebuild_history(const state &state)
 
 	static const m::event::fetch::opts fopts
 	{
-		{ db::get::NO_CACHE }
+		{ db::get::NO_CACHE, db::get::SCAN }
 	};
 
 	const m::room room
@@ -734,7 +734,7 @@ ircd::m::room::state::clear_history(const state &state)
 {
 	static const db::gopts gopts
 	{
-		db::get::NO_CACHE
+		db::get::NO_CACHE, db::get::SCAN
 	};
 
 	db::txn txn
@@ -894,7 +894,7 @@ dagree_histogram(const m::room &room,
 {
 	static const m::event::fetch::opts fopts
 	{
-		{ db::get::NO_CACHE },
+		{ db::get::NO_CACHE, db::get::SCAN },
 		m::event::keys::include
 		{
 			"event_id",
@@ -1052,7 +1052,7 @@ ircd::m::room::stats::bytes_json(const m::room &room)
 
 		static const db::gopts gopts
 		{
-			db::get::NO_CACHE
+			db::get::NO_CACHE, db::get::SCAN
 		};
 
 		ret += db::bytes_value(m::dbs::event_json, key, gopts);
@@ -18,60 +18,255 @@ IRCD_MODULE
 
 namespace ircd::m::state
 {
+	static void gc_mark(gc &, const id &root);
+	static void gc_barrier(const uint64_t &eval_id);
+
+	extern conf::item<size_t> gc_batch;
+	extern conf::item<milliseconds> gc_delay;
+	extern conf::item<bool> gc_compact;
+	extern conf::item<size_t> gc_log_interval;
+	extern stats::item gc_stats_runs;
+	extern stats::item gc_stats_roots;
+	extern stats::item gc_stats_reads;
+	extern stats::item gc_stats_marked;
+	extern stats::item gc_stats_swept;
+	extern std::unique_ptr<gc> gc_current;
+	extern size_t gc_visits;
+
 	extern "C" void ircd__m__state__clear(void);
 	extern "C" size_t ircd__m__state__gc(void);
 }
 
+/// Number of nodes read by the mark between each pause.
+decltype(ircd::m::state::gc_batch)
+ircd::m::state::gc_batch
+{
+	{ "name",     "ircd.m.state.gc.batch" },
+	{ "default",  4096L                   },
+};
+
+/// Duration of each pause in the mark; this throttles the collector's
+/// reads so it can run alongside normal operation.
+decltype(ircd::m::state::gc_delay)
+ircd::m::state::gc_delay
+{
+	{ "name",     "ircd.m.state.gc.delay" },
+	{ "default",  25L                     },
+};
+
+/// Compact the state_node column when the mark is complete rather than
+/// waiting for normal compaction to sweep. The collection is released
+/// after the compaction.
+decltype(ircd::m::state::gc_compact)
+ircd::m::state::gc_compact
+{
+	{ "name",     "ircd.m.state.gc.compact" },
+	{ "default",  false                     },
+};
+
+/// Number of nodes read by the mark between each progress report.
+decltype(ircd::m::state::gc_log_interval)
+ircd::m::state::gc_log_interval
+{
+	{ "name",     "ircd.m.state.gc.log.interval" },
+	{ "default",  262144L                        },
+};
+
+decltype(ircd::m::state::gc_stats_runs)
+ircd::m::state::gc_stats_runs
+{
+	{ "name", "ircd.m.state.gc.runs" },
+};
+
+decltype(ircd::m::state::gc_stats_roots)
+ircd::m::state::gc_stats_roots
+{
+	{ "name", "ircd.m.state.gc.roots" },
+};
+
+decltype(ircd::m::state::gc_stats_reads)
+ircd::m::state::gc_stats_reads
+{
+	{ "name", "ircd.m.state.gc.reads" },
+};
+
+decltype(ircd::m::state::gc_stats_marked)
+ircd::m::state::gc_stats_marked
+{
+	{ "name", "ircd.m.state.gc.marked" },
+};
+
+decltype(ircd::m::state::gc_stats_swept)
+ircd::m::state::gc_stats_swept
+{
+	{ "name", "ircd.m.state.gc.swept" },
+};
+
+/// The last collection. It remains here after the mark so its filter can
+/// sweep as normal compaction visits the column; a new collection replaces
+/// it. Released when the module is unloaded.
+decltype(ircd::m::state::gc_current)
+ircd::m::state::gc_current;
+
+decltype(ircd::m::state::gc_visits)
+ircd::m::state::gc_visits;
+
+/// Mark and sweep the state_node column. The marks are kept in memory and
+/// the sweep takes place in the column's compaction filter, see: state::gc.
+/// Returns the number of live nodes marked.
 size_t
 ircd::m::state::ircd__m__state__gc()
 {
-	std::set<id_buffer> heads;
+	if(gc_current && !gc_current->sweeping)
+		throw m::error
+		{
+			"A state node collection is already marking."
+		};
+
+	// Any previous collection is released; its sweep stops here.
+	gc_current.reset();
+	gc_current = std::make_unique<gc>();
+	auto &gc(*gc_current);
+	gc_visits = 0;
+	gc_stats_runs += 1;
+	gc_stats_marked = 0;
+
+	// A collection which doesn't finish marking is useless.
+	const unwind::exceptional release{[]
 	{
-		const db::gopts opts{db::get::NO_CACHE};
-		//opts.readahead = 4_MiB;
+		gc_current.reset();
+	}};
 
+	// From here set_node() marks its nodes, but evals which built their txn
+	// before that may still commit a new root referring to unmarked nodes;
+	// wait for them so the iteration below will see those roots.
+	gc_barrier(vm::eval::id_ctr);
+
+	const ircd::timer timer;
+
+	log::info
+	{
+		m::log, "State node collection started; marking from room_events..."
+	};
+
+	{
+		const db::gopts opts{db::get::NO_CACHE, db::get::SCAN};
 		db::column &column{m::dbs::room_events};
 		for(auto it(column.begin(opts)); it; ++it)
 		{
 			const auto &root(it->second);
-			id_buffer buf;
-			copy(buf, root);
-			heads.emplace(buf);
+			if(empty(root) || gc.marked(root))
+				continue;
+
+			// Copied because the iterator may be invalidated by the yields.
+			char buf[ID_MAX_SZ];
+			gc_mark(gc, string_view{buf, strlcpy(buf, root)});
+			++gc.roots;
+			gc_stats_roots += 1;
 		}
 	}
 
-	std::set<id_buffer> active;
-	for(auto it(begin(heads)); it != end(heads); it = heads.erase(it))
+	gc.sweep();
+	gc_stats_marked = gc.count();
+	char tmbuf[48];
+	log::info
 	{
-		const auto &root(*it);
-		std::cout << "root: " << string_view{root} << std::endl;
-		state::for_each(root, state::iter_bool_closure{[&active]
-		(const json::array &key, const string_view &val)
+		m::log, "State node collection marked %zu nodes from %zu roots; %zu reads in %s. Sweeping.",
+		gc.count(),
+		gc.roots,
+		gc_visits,
+		util::pretty(tmbuf, timer.at<milliseconds>(), true),
+	};
+
+	if(gc_compact)
+	{
+		// The column's filter is replaced by the argument for a manual
+		// compaction so it has to be given here.
+		db::compact(m::dbs::state_node, {-1, -1}, db::compactor
+		{
+			gc::filter
+		});
+		log::info
 		{
-			std::cout << "key: " << key << std::endl;
-			std::cout << "val: " << val << std::endl;
-			return true;
-		}});
+			m::log, "State node collection swept %zu nodes; %zu kept.",
+			gc.swept,
+			gc.kept,
+		};
+
+		gc_stats_swept += gc.swept;
 
-		break;
+		const size_t ret(gc.count());
+		gc_current.reset();
+		return ret;
 	}
-/*
-	static const db::gopts opts
+
+	return gc.count();
+}
+
+void
+ircd::m::state::gc_mark(gc &gc,
+                        const id &node_id)
+{
+	if(!gc.mark(node_id))
+		return;
+
+	// Collect the children first so the node isn't held while this recurses.
+	std::vector<std::string> children;
+	get_node(std::nothrow, node_id, [&children]
+	(const string_view &node)
 	{
-		db::get::NO_CACHE
-	};
+		const node::rep rep{node};
+		children.reserve(rep.cn);
+		for(size_t i(0); i < rep.cn; ++i)
+			if(!empty(rep.chld[i]))
+				children.emplace_back(rep.chld[i]);
+	});
 
-	auto &column{m::dbs::state_node};
-	for(auto it(column.begin(opts)); it; ++it)
+	gc_stats_reads += 1;
+	if(++gc_visits % size_t(gc_log_interval) == 0)
+		log::info
+		{
+			m::log, "State node collection marked %zu nodes from %zu roots; %zu reads...",
+			gc.count(),
+			gc.roots,
+			gc_visits,
+		};
+
+	if(gc_visits % size_t(gc_batch) == 0)
 	{
-		id_buffer buf;
-		const auto &root(it->second);
-		copy(buf, root);
-		active.emplace(buf);
+		gc_stats_marked = gc.count();
+		log::debug
+		{
+			m::log, "State node collection marked %zu nodes from %zu roots...",
+			gc.count(),
+			gc.roots,
+		};
+
+		const milliseconds delay(gc_delay);
+		if(delay > 0ms)
+			ctx::sleep(delay);
+		else
+			ctx::yield();
 	}
-*/
-	size_t ret(active.size());
-	return ret;
+
+	for(const auto &child : children)
+		gc_mark(gc, child);
+}
+
+void
+ircd::m::state::gc_barrier(const uint64_t &eval_id)
+{
+	const auto pending{[&eval_id]
+	{
+		return std::any_of(begin(vm::eval::list), end(vm::eval::list), [&eval_id]
+		(const vm::eval *const &eval)
+		{
+			return eval->id <= eval_id;
+		});
+	}};
+
+	while(pending())
+		ctx::sleep(milliseconds(250));
 }
 
 void
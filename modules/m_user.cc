@@ -154,3 +154,56 @@ highlighted_count(const user &user,
 
 	return highlighted_count__since(user, room, current);
 }
+
+/// A token issued to the tokens room may have been presented before it was
+/// issued and cached as invalid by resource::method::authenticate().
+static void
+handle_access_token_issue(const event &event,
+                          vm::eval &eval)
+{
+	resource::method::token_cache::clear(at<"state_key"_>(event));
+}
+
+hookfn<vm::eval &>
+access_token_issue_hook
+{
+	handle_access_token_issue,
+	{
+		{ "_site",     "vm.notify"         },
+		{ "room_id",   "!tokens"           },
+		{ "type",      "ircd.access_token" },
+	}
+};
+
+/// A token redacted from the tokens room (i.e logout) must stop working
+/// immediately rather than linger in resource::method::authenticate()'s
+/// cache.
+static void
+handle_access_token_redact(const event &event,
+                           vm::eval &eval)
+{
+	const auto &target
+	{
+		json::get<"redacts"_>(event)
+	};
+
+	if(!target)
+		return;
+
+	get(std::nothrow, target, "state_key", []
+	(const string_view &access_token)
+	{
+		resource::method::token_cache::clear(access_token);
+	});
+}
+
+hookfn<vm::eval &>
+access_token_redact_hook
+{
+	handle_access_token_redact,
+	{
+		{ "_site",     "vm.notify"         },
+		{ "room_id",   "!tokens"           },
+		{ "type",      "m.room.redaction"  },
+	}
+};
@@ -63,6 +63,31 @@ get__metrics(client &client,
 	    << ' ' << ts
 	    << '\n';
 
+	out << "iou_requests_total"
+	    << ' ' << fs::iou::stats.requests
+	    << ' ' << ts
+	    << '\n';
+
+	out << "iou_requests_bytes_total"
+	    << ' ' << fs::iou::stats.bytes_requests
+	    << ' ' << ts
+	    << '\n';
+
+	out << "iou_submits_total"
+	    << ' ' << fs::iou::stats.submits
+	    << ' ' << ts
+	    << '\n';
+
+	out << "iou_retries_total"
+	    << ' ' << fs::iou::stats.retries
+	    << ' ' << ts
+	    << '\n';
+
+	out << "iou_errors_total"
+	    << ' ' << fs::iou::stats.errors
+	    << ' ' << ts
+	    << '\n';
+
 	const string_view output
 	{
 		view(out, buf)
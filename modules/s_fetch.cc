@@ -30,6 +30,46 @@ ircd::m::fetch::timeout
 	{ "default",  10L                    },
 };
 
+/// Fraction of requests sent to a random origin rather than the fastest
+/// known; this discovers the latency of servers we have not talked to.
+decltype(ircd::m::fetch::select_explore)
+ircd::m::fetch::select_explore
+{
+	{ "name",     "ircd.m.fetch.select.explore" },
+	{ "default",  0.10                          },
+};
+
+decltype(ircd::m::fetch::hedge_enable)
+ircd::m::fetch::hedge_enable
+{
+	{ "name",     "ircd.m.fetch.hedge.enable" },
+	{ "default",  true                        },
+};
+
+/// A hedged request is sent when the first has been outstanding longer than
+/// this percentile of the first origin's recent response times.
+decltype(ircd::m::fetch::hedge_percentile)
+ircd::m::fetch::hedge_percentile
+{
+	{ "name",     "ircd.m.fetch.hedge.percentile" },
+	{ "default",  0.95                            },
+};
+
+/// Hedge delay when the first origin's response times are not yet known.
+decltype(ircd::m::fetch::hedge_default)
+ircd::m::fetch::hedge_default
+{
+	{ "name",     "ircd.m.fetch.hedge.default" },
+	{ "default",  2000L                        },
+};
+
+decltype(ircd::m::fetch::hedge_min)
+ircd::m::fetch::hedge_min
+{
+	{ "name",     "ircd.m.fetch.hedge.min" },
+	{ "default",  250L                     },
+};
+
 decltype(ircd::m::fetch::hook)
 ircd::m::fetch::hook
 {
@@ -563,12 +603,47 @@ ircd::m::fetch::request_cleanup()
 void
 ircd::m::fetch::request_handle()
 {
+	// Overdue hedges are sent on every pass rather than only when the wait
+	// times out; while busy, the wait is mostly ended by other requests
+	// completing before the deadline is reached.
+	const auto cur(now<steady_point>());
+	for(const auto &request : requests)
+		if(!request.finished && request.hedge_at != steady_point{} && request.hedge_at <= cur)
+			hedge(const_cast<fetch::request &>(request));
+
+	// Each request is waited on along with its hedge, if any; the second
+	// member indicates the hedge.
+	std::vector<std::pair<decltype(requests)::iterator, bool>> pending;
+	pending.reserve(requests.size() * 2);
+
+	auto deadline
+	{
+		cur + seconds(timeout)
+	};
+
+	for(auto it(begin(requests)); it != end(requests); ++it)
+	{
+		pending.emplace_back(it, false);
+		if(it->hedge)
+			pending.emplace_back(it, true);
+
+		if(it->hedge_at != steady_point{} && !it->finished)
+			deadline = std::min(deadline, it->hedge_at);
+	}
+
 	auto next
 	{
-		ctx::when_any(requests.begin(), requests.end())
+		ctx::when_any(begin(pending), end(pending), []
+		(auto &it) -> ctx::future<http::code> &
+		{
+			auto &request(const_cast<fetch::request &>(*it->first));
+			return it->second?
+				static_cast<ctx::future<http::code> &>(*request.hedge):
+				static_cast<ctx::future<http::code> &>(request);
+		})
 	};
 
-	if(!next.wait(seconds(timeout), std::nothrow))
+	if(!next.wait_until(deadline, std::nothrow))
 	{
 		const auto now(ircd::time());
 		for(const auto &request : requests)
@@ -583,14 +658,15 @@ ircd::m::fetch::request_handle()
 		next.get()
 	};
 
-	if(it == end(requests))
+	if(it == end(pending))
 		return;
 
-	request_handle(it);
+	request_handle(it->first, it->second);
 }
 
 void
-ircd::m::fetch::request_handle(const decltype(requests)::iterator &it)
+ircd::m::fetch::request_handle(const decltype(requests)::iterator &it,
+                               const bool &hedge)
 try
 {
 	auto &request
@@ -601,7 +677,7 @@ try
 	if(!request.started || !request.last || request.finished)
 		return;
 
-	if(!handle(request))
+	if(!(hedge? handle_hedge(request) : handle(request)))
 		return;
 
 	assert(request.finished);
@@ -741,7 +817,7 @@ ircd::m::fetch::start(request &request)
 	m::v1::event::opts opts;
 	opts.dynamic = true;
 	if(!request.origin)
-		select_random_origin(request);
+		request.origin = select_origin(request);
 
 	opts.remote = request.origin;
 	return start(request, opts);
@@ -762,6 +838,10 @@ try
 		request.event_id, request.buf, std::move(opts)
 	};
 
+	request.hedge_at = hedge_enable && !request.hedge?
+		now<steady_point>() + hedge_delay(request.origin):
+		steady_point{};
+
 	log::debug
 	{
 		log, "Started request for %s in %s from '%s'",
@@ -805,6 +885,83 @@ catch(const std::exception &e)
 	return false;
 }
 
+/// Select an origin for a request which has not yet been attempted. The
+/// fastest healthy origin by the server scoreboard is preferred; a random
+/// origin is selected when no latency is known, or by chance to explore.
+ircd::string_view
+ircd::m::fetch::select_origin(request &request)
+{
+	const bool explore
+	{
+		rand::integer(0, 999) < uint64_t(double(select_explore) * 1000)
+	};
+
+	string_view ret;
+	if(!explore)
+		ret = select_fastest_origin(request);
+
+	if(!ret)
+		ret = select_random_origin(request);
+
+	if(!ret)
+		throw m::NOT_FOUND
+		{
+			"Cannot find any server to fetch %s in %s",
+			string_view{request.event_id},
+			string_view{request.room_id},
+		};
+
+	return ret;
+}
+
+ircd::string_view
+ircd::m::fetch::select_fastest_origin(request &request)
+{
+	const m::room::origins origins
+	{
+		request.room_id
+	};
+
+	std::string best;
+	milliseconds best_latency {0};
+	origins.for_each([&request, &best, &best_latency]
+	(const string_view &origin)
+	{
+		if(!proffer(request, origin))
+			return;
+
+		if(!ircd::server::exists(origin))
+			return;
+
+		const auto &peer
+		{
+			ircd::server::find(origin)
+		};
+
+		if(!peer.healthy())
+			return;
+
+		const auto latency
+		{
+			peer.latency()
+		};
+
+		// Not measured yet
+		if(latency == milliseconds(0))
+			return;
+
+		if(!best.empty() && latency >= best_latency)
+			return;
+
+		best = origin;
+		best_latency = latency;
+	});
+
+	return !best.empty()?
+		select_origin(request, best):
+		string_view{};
+}
+
 ircd::string_view
 ircd::m::fetch::select_random_origin(request &request)
 {
@@ -814,40 +971,21 @@ ircd::m::fetch::select_random_origin(request &request)
 	};
 
 	// copies randomly selected origin into the attempted set.
-	const auto closure{[&request]
+	string_view ret;
+	const auto closure{[&request, &ret]
 	(const string_view &origin)
 	{
-		select_origin(request, origin);
+		ret = select_origin(request, origin);
 	}};
 
-	// Tests if origin is potentially viable
-	const auto proffer{[&request]
+	const auto viable{[&request]
 	(const string_view &origin)
 	{
-		// Don't want to request from myself.
-		if(my_host(origin))
-			return false;
-
-		// Don't want to use a peer we already tried and failed with.
-		if(request.attempted.count(origin))
-			return false;
-
-		// Don't want to use a peer marked with an error by ircd::server
-		if(ircd::server::errmsg(origin))
-			return false;
-
-		return true;
+		return proffer(request, origin);
 	}};
 
-	if(!origins.random(closure, proffer) || !request.origin)
-		throw m::NOT_FOUND
-		{
-			"Cannot find any server to fetch %s in %s",
-			string_view{request.event_id},
-			string_view{request.room_id},
-		};
-
-	return request.origin;
+	origins.random(closure, viable);
+	return ret;
 }
 
 ircd::string_view
@@ -859,8 +997,124 @@ ircd::m::fetch::select_origin(request &request,
 		request.attempted.emplace(std::string{origin})
 	};
 
-	request.origin = *iit.first;
-	return request.origin;
+	return *iit.first;
+}
+
+/// Tests if origin is potentially viable
+bool
+ircd::m::fetch::proffer(const request &request,
+                        const string_view &origin)
+{
+	// Don't want to request from myself.
+	if(my_host(origin))
+		return false;
+
+	// Don't want to use a peer we already tried and failed with.
+	if(request.attempted.count(origin))
+		return false;
+
+	// Don't want to use a peer marked with an error by ircd::server
+	if(ircd::server::errmsg(origin))
+		return false;
+
+	return true;
+}
+
+/// Time to wait on an origin before hedging; this is the configured
+/// percentile of its recent response times, bounded by the minimum and the
+/// request timeout.
+ircd::milliseconds
+ircd::m::fetch::hedge_delay(const string_view &origin)
+{
+	milliseconds ret
+	{
+		hedge_default
+	};
+
+	if(ircd::server::exists(origin))
+	{
+		const auto &peer
+		{
+			ircd::server::find(origin)
+		};
+
+		const auto latency
+		{
+			peer.latency(hedge_percentile)
+		};
+
+		if(latency > milliseconds(0))
+			ret = latency;
+	}
+
+	return std::clamp(ret, milliseconds(hedge_min), duration_cast<milliseconds>(seconds(timeout)));
+}
+
+/// Send a second request for the event to another origin while the first
+/// is still outstanding.
+bool
+ircd::m::fetch::hedge(request &request)
+try
+{
+	assert(!request.finished);
+	request.hedge_at = steady_point{};
+	if(request.hedge)
+		return false;
+
+	const string_view origin
+	{
+		select_origin(request)
+	};
+
+	m::v1::event::opts opts;
+	opts.dynamic = true;
+	opts.remote = origin;
+	request.hedge_buf = unique_buffer<mutable_buffer>
+	{
+		size(request.buf)
+	};
+
+	request.hedge = std::make_unique<m::v1::event>(request.event_id, request.hedge_buf, std::move(opts));
+	request.hedge_origin = origin;
+
+	log::debug
+	{
+		log, "Hedged request for %s in %s from '%s' after '%s'",
+		string_view{request.event_id},
+		string_view{request.room_id},
+		string_view{request.hedge_origin},
+		string_view{request.origin},
+	};
+
+	return true;
+}
+catch(const std::exception &e)
+{
+	log::derror
+	{
+		log, "Failed to hedge request for %s in %s :%s",
+		string_view{request.event_id},
+		string_view{request.room_id},
+		e.what(),
+	};
+
+	request.hedge.reset();
+	request.hedge_origin = {};
+	return false;
+}
+
+/// The hedged request becomes the request; the first is canceled.
+void
+ircd::m::fetch::promote(request &request)
+{
+	assert(request.hedge);
+	*static_cast<m::v1::event *>(&request) = std::move(*request.hedge);
+	std::swap(request.buf, request.hedge_buf);
+	request.origin = request.hedge_origin;
+	request.last = ircd::time();
+	request.hedge.reset();
+	request.hedge_buf = {};
+	request.hedge_origin = {};
 }
 
 bool
@@ -905,6 +1159,54 @@ ircd::m::fetch::handle(request &request)
 	return request.finished;
 }
 
+/// The hedged request completed before the first. If it succeeded it takes
+/// the place of the first, which is canceled; if it failed the first is
+/// left to complete on its own.
+bool
+ircd::m::fetch::handle_hedge(request &request)
+{
+	assert(request.hedge);
+	auto &hedge(*request.hedge);
+	hedge.wait(); try
+	{
+		const auto code
+		{
+			hedge.get()
+		};
+
+		log::debug
+		{
+			log, "%u %s for %s in %s from '%s' (hedged after '%s')",
+			uint(code),
+			status(code),
+			string_view{request.event_id},
+			string_view{request.room_id},
+			string_view{request.hedge_origin},
+			string_view{request.origin},
+		};
+	}
+	catch(const std::exception &e)
+	{
+		log::derror
+		{
+			log, "Failure for %s in %s from '%s' (hedged) :%s",
+			string_view{request.event_id},
+			string_view{request.room_id},
+			string_view{request.hedge_origin},
+			e.what(),
+		};
+
+		request.hedge.reset();
+		request.hedge_buf = {};
+		request.hedge_origin = {};
+		return false;
+	}
+
+	promote(request);
+	finish(request);
+	return request.finished;
+}
+
 void
 ircd::m::fetch::retry(request &request)
 try
@@ -914,6 +1216,11 @@ try
 	server::cancel(request);
 	request.eptr = std::exception_ptr{};
 	request.origin = {};
+
+	// A hedged request already outstanding is continued in place of a new one.
+	if(request.hedge)
+		return promote(request);
+
 	start(request);
 }
 catch(...)
@@ -927,6 +1234,8 @@ ircd::m::fetch::finish(request &request)
 {
 	assert(request.started);
 	request.finished = ircd::time();
+	request.hedge_at = steady_point{};
+	request.hedge.reset();
 	dock.notify_all();
 }
 
@@ -26,21 +26,33 @@ namespace ircd::m::fetch
 	extern hookfn<vm::eval &> hook;
 	extern conf::item<seconds> timeout;
 	extern conf::item<bool> enable;
+	extern conf::item<double> select_explore;
+	extern conf::item<bool> hedge_enable;
+	extern conf::item<double> hedge_percentile;
+	extern conf::item<milliseconds> hedge_default;
+	extern conf::item<milliseconds> hedge_min;
 
 	static bool timedout(const request &, const time_t &now);
 	static string_view select_origin(request &, const string_view &);
 	static string_view select_random_origin(request &);
+	static string_view select_fastest_origin(request &);
+	static string_view select_origin(request &);
+	static bool proffer(const request &, const string_view &origin);
+	static milliseconds hedge_delay(const string_view &origin);
+	static bool hedge(request &);
+	static void promote(request &);
 	static void finish(request &);
 	static void retry(request &);
 	static bool start(request &, m::v1::event::opts &);
 	static bool start(request &);
+	static bool handle_hedge(request &);
 	static bool handle(request &);
 
 	template<class... args> static bool submit(const event::id &, const room::id &, const size_t &bufsz = 8_KiB, args&&...);
 	static void eval_handle(const decltype(requests)::iterator &);
 	static void eval_handle();
 	static void eval_worker();
-	static void request_handle(const decltype(requests)::iterator &);
+	static void request_handle(const decltype(requests)::iterator &, const bool &hedge);
 	static void request_handle();
 	static size_t request_cleanup();
 	static void request_worker();
@@ -10,6 +10,7 @@
 
 namespace ircd::m::vm
 {
+	static void write_commit_group(eval &);
 	static void write_commit(eval &);
 	static void write_append(eval &, const event &);
 	static void write_prepare(eval &, const event &);
@@ -41,6 +42,13 @@ namespace ircd::m::vm
 	extern conf::item<size_t> pool_size;
 	extern const ctx::pool::opts pool_opts;
 	extern ctx::pool pool;
+
+	extern conf::item<bool> commit_group_enable;
+	extern conf::item<size_t> commit_group_max;
+	extern conf::item<microseconds> commit_group_delay;
+	extern std::deque<eval *> commit_queue;
+	extern ctx::ctx *commit_leader;
+	extern ctx::dock commit_dock;
 }
 
 ircd::mapi::header
@@ -71,6 +79,39 @@ ircd::m::vm::log_accept_info
 	{ "default",  false                       },
 };
 
+decltype(ircd::m::vm::commit_group_enable)
+ircd::m::vm::commit_group_enable
+{
+	{ "name",     "ircd.m.vm.commit.group.enable" },
+	{ "default",  true                            },
+};
+
+decltype(ircd::m::vm::commit_group_max)
+ircd::m::vm::commit_group_max
+{
+	{ "name",     "ircd.m.vm.commit.group.max" },
+	{ "default",  64L                          },
+};
+
+/// Time the leader of a commit group waits for other evals to join it. At
+/// zero the leader only yields once so evals ready in the same iteration of
+/// the event loop are included.
+decltype(ircd::m::vm::commit_group_delay)
+ircd::m::vm::commit_group_delay
+{
+	{ "name",     "ircd.m.vm.commit.group.delay" },
+	{ "default",  0L                             },
+};
+
+decltype(ircd::m::vm::commit_queue)
+ircd::m::vm::commit_queue;
+
+decltype(ircd::m::vm::commit_leader)
+ircd::m::vm::commit_leader;
+
+decltype(ircd::m::vm::commit_dock)
+ircd::m::vm::commit_dock;
+
 decltype(ircd::m::vm::issue_hook)
 ircd::m::vm::issue_hook
 {
@@ -718,7 +759,7 @@ ircd::m::vm::execute_pdu(eval &eval,
 		};
 
 	if(opts.verify)
-		if(!verify(event))
+		if(eval.verified? !*eval.verified : !verify(event))
 			throw m::BAD_SIGNATURE
 			{
 				"Signature verification failed"
@@ -939,7 +980,10 @@ ircd::m::vm::write_commit(eval &eval)
 	const auto db_seq_before(db::sequence(*m::dbs::events));
 	#endif
 
-	txn();
+	if(commit_group_enable)
+		write_commit_group(eval);
+	else
+		txn();
 
 	#ifdef RB_DEBUG
 	const auto db_seq_after(db::sequence(*m::dbs::events));
@@ -957,3 +1001,111 @@ ircd::m::vm::write_commit(eval &eval)
 	};
 	#endif
 }
+
+/// Evals on different contexts reaching their commit around the same time
+/// are written together: the first becomes the leader, lets the others queue
+/// behind it, and commits all of the queued transactions with one write to
+/// the database. The followers wait for their transaction to be committed.
+/// Sequence retirement is unaffected; it still takes place in order after
+/// this returns.
+void
+ircd::m::vm::write_commit_group(eval &eval)
+{
+	// An eval must never leave the queue while its transaction is referenced.
+	const ctx::uninterruptible::nothrow ui;
+
+	auto &txn(*eval.txn);
+	commit_queue.emplace_back(&eval);
+	commit_dock.wait([&txn]
+	{
+		return !commit_leader || txn.state != db::txn::state::BUILD;
+	});
+
+	// Committed by the leader of a group including this eval. If the state
+	// is not COMMITTED then the leader failed to write this transaction.
+	if(txn.state != db::txn::state::BUILD)
+	{
+		if(unlikely(txn.state != db::txn::state::COMMITTED))
+			throw error
+			{
+				fault::GENERAL, "Transaction failed to commit with its group."
+			};
+
+		return;
+	}
+
+	assert(!commit_leader);
+	commit_leader = ctx::current;
+	const unwind release{[]
+	{
+		commit_leader = nullptr;
+		commit_dock.notify_all();
+	}};
+
+	const microseconds delay
+	{
+		commit_group_delay
+	};
+
+	if(delay > 0us)
+		ctx::sleep(delay);
+	else
+		ctx::yield();
+
+	// Groups are taken from the front of the queue until this eval's own
+	// transaction has been written.
+	std::exception_ptr eptr;
+	std::vector<db::txn *> txns;
+	while(txn.state == db::txn::state::BUILD)
+	{
+		assert(!commit_queue.empty());
+		const auto count
+		{
+			std::min(commit_queue.size(), std::max(size_t(commit_group_max), 1UL))
+		};
+
+		txns.resize(count);
+		for(size_t i(0); i < count; ++i)
+		{
+			assert(commit_queue.front()->txn);
+			txns[i] = commit_queue.front()->txn.get();
+			commit_queue.pop_front();
+		}
+
+		try
+		{
+			db::commit(txns);
+			continue;
+		}
+		catch(const std::exception &e)
+		{
+			log::error
+			{
+				log, "%s | group commit of %zu transactions :%s",
+				loghead(eval),
+				txns.size(),
+				e.what(),
+			};
+
+			// A group of one has already been attempted individually.
+			if(txns.size() == 1 && txns[0] == &txn)
+				eptr = std::current_exception();
+		}
+
+		// The group failed; commit each individually so only the offending
+		// transaction fails. Each follower observes its own outcome.
+		for(auto *const other : txns) try
+		{
+			if(other->state == db::txn::state::BUILD)
+				(*other)();
+		}
+		catch(const std::exception &e)
+		{
+			if(other == &txn)
+				eptr = std::current_exception();
+		}
+	}
+
+	if(eptr)
+		std::rethrow_exception(eptr);
+}